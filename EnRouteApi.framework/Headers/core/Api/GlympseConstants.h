@@ -451,7 +451,7 @@ namespace Glympse
      */
     public: static GString TICKET_VISIBILITY_LOCATION_VISIBLE()
     {
-        return CoreFactory::createString("visible");
+        return CoreFactory::internString("visible");
     }
 
     /**
@@ -459,7 +459,7 @@ namespace Glympse
      */
     public: static GString TICKET_VISIBILITY_LOCATION_HIDDEN()
     {
-        return CoreFactory::createString("hidden");
+        return CoreFactory::internString("hidden");
     }
 
     /**
@@ -467,7 +467,7 @@ namespace Glympse
      */
     public: static GString TICKET_VISIBILITY_KEY_LOCATION()
     {
-        return CoreFactory::createString("location");
+        return CoreFactory::internString("location");
     }
 
     /**
@@ -475,7 +475,7 @@ namespace Glympse
      */
     public: static GString TICKET_VISIBILITY_KEY_CONTEXT()
     {
-        return CoreFactory::createString("context");
+        return CoreFactory::internString("context");
     }
 
     /**
@@ -487,7 +487,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_FACEBOOK()
     {
-        return CoreFactory::createString("facebook");
+        return CoreFactory::internString("facebook");
     }
     
     /**
@@ -495,7 +495,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_TWITTER()
     {
-        return CoreFactory::createString("twitter");
+        return CoreFactory::internString("twitter");
     }
     
     /**
@@ -503,7 +503,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_EVERNOTE()
     {
-        return CoreFactory::createString("evernote");
+        return CoreFactory::internString("evernote");
     }
 
     /**
@@ -511,7 +511,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_GOOGLE()
     {
-        return CoreFactory::createString("google_plus");
+        return CoreFactory::internString("google_plus");
     }
 
     /**
@@ -519,7 +519,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_PAIRING()
     {
-        return CoreFactory::createString("pairing");
+        return CoreFactory::internString("pairing");
     }
     
     /**
@@ -527,7 +527,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_PHONE()
     {
-        return CoreFactory::createString("phone");
+        return CoreFactory::internString("phone");
     }
     
     /**
@@ -535,7 +535,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_TYPE_EMAIL()
     {
-        return CoreFactory::createString("email");
+        return CoreFactory::internString("email");
     }
 
    /**
@@ -550,7 +550,7 @@ namespace Glympse
      */
     public: static GString LINKED_ACCOUNT_PROPERTY_INVITE_CLIENT_SEND()
     {
-        return CoreFactory::createString("invite_client_send");
+        return CoreFactory::internString("invite_client_send");
     }
 
     /**
@@ -826,17 +826,17 @@ namespace Glympse
      */
     public: static GString CARD_OBJECT_TYPE_POI()
     {
-        return CoreFactory::createString("poi");
+        return CoreFactory::internString("poi");
     }
     
     public: static GString CARD_OBJECT_TYPE_INVITE()
     {
-        return CoreFactory::createString("invite");
+        return CoreFactory::internString("invite");
     }
     
     public: static GString CARD_OBJECT_TYPE_UNKNOWN()
     {
-        return CoreFactory::createString("unknown");
+        return CoreFactory::internString("unknown");
     }
     
     /**
@@ -898,7 +898,7 @@ namespace Glympse
      */
     public: static GString CARD_ID_PRIVATE_GROUP()
     {
-        return CoreFactory::createString("559364b74d76b03a2f46096e");
+        return CoreFactory::internString("559364b74d76b03a2f46096e");
     }
 
 };
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef ARENA_H__GLYMPSE__
+#define ARENA_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Bump allocator for objects sharing a single lifetime.
+ *
+ * Memory is carved sequentially out of chunks obtained from the heap. Individual allocations are never
+ * freed; all chunks are released at once when the arena is destroyed. Chunk size doubles with every chunk
+ * (up to MAX_CHUNK_SIZE), so the number of heap allocations grows logarithmically with the amount of data.
+ * Requests larger than a quarter of MAX_CHUNK_SIZE get a dedicated chunk.
+ *
+ * Objects placed into the arena are not destroyed, so only trivially destructible types should be stored.
+ * The arena is not thread safe.
+ */
+class Arena
+{
+    public: static const int32 MIN_CHUNK_SIZE = 1024;
+
+    public: static const int32 MAX_CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * Chunk header. Data follows the header.
+     */
+    private: struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    private: Chunk* _chunks;
+
+    private: char* _position;
+
+    private: char* _limit;
+
+    private: size_t _nextSize;
+
+    private: size_t _reserved;
+
+    private: size_t _used;
+
+    /**
+     * Creates the arena. The first chunk is allocated lazily and holds at least initialSize bytes.
+     */
+    public: explicit Arena(int32 initialSize = MIN_CHUNK_SIZE)
+        : _chunks(NULL)
+        , _position(NULL)
+        , _limit(NULL)
+        , _nextSize(( initialSize > MIN_CHUNK_SIZE ) ? ( ( initialSize < MAX_CHUNK_SIZE ) ? initialSize : MAX_CHUNK_SIZE ) : MIN_CHUNK_SIZE)
+        , _reserved(0)
+        , _used(0)
+    {
+    }
+
+    public: ~Arena()
+    {
+        while ( NULL != _chunks )
+        {
+            Chunk* next = _chunks->next;
+            ::operator delete(_chunks);
+            _chunks = next;
+        }
+    }
+
+    private: Arena(const Arena&);
+
+    private: Arena& operator=(const Arena&);
+
+    /**
+     * Returns size bytes of memory aligned to alignment (a power of two).
+     */
+    public: inline void* allocate(size_t size, size_t alignment = alignof(double))
+    {
+        char* result = align(_position, alignment);
+        if ( ( NULL == _position ) || ( result > _limit ) || ( size > (size_t)( _limit - result ) ) )
+        {
+            return allocateSlow(size, alignment);
+        }
+        _position = result + size;
+        _used += size;
+        return result;
+    }
+
+    /**
+     * Returns uninitialized storage for count objects of type T.
+     */
+    public: template< class T > inline T* allocateArray(int32 count)
+    {
+        return (T*)allocate(sizeof(T) * count, alignof(T));
+    }
+
+    /**
+     * Copies length characters into the arena and returns the copy. The copy is not zero-terminated.
+     */
+    public: inline const char* copy(const char* chars, int32 length)
+    {
+        char* target = (char*)allocate(length, 1);
+        memcpy(target, chars, length);
+        return target;
+    }
+
+    /**
+     * Returns number of bytes handed out so far.
+     */
+    public: size_t getUsedSize() const
+    {
+        return _used;
+    }
+
+    /**
+     * Returns number of bytes obtained from the heap.
+     */
+    public: size_t getReservedSize() const
+    {
+        return _reserved;
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static inline char* align(char* position, size_t alignment)
+    {
+        return (char*)( ( (size_t)position + alignment - 1 ) & ~( alignment - 1 ) );
+    }
+
+    private: void* allocateSlow(size_t size, size_t alignment)
+    {
+        size_t required = size + alignment;
+        if ( required > MAX_CHUNK_SIZE / 4 )
+        {
+            // Dedicated chunk goes behind the current one, so that the free space of the latter is not lost.
+            Chunk* chunk = createChunk(required);
+            if ( NULL != _chunks )
+            {
+                chunk->next = _chunks->next;
+                _chunks->next = chunk;
+            }
+            else
+            {
+                chunk->next = NULL;
+                _chunks = chunk;
+            }
+            _used += size;
+            return align((char*)( chunk + 1 ), alignment);
+        }
+
+        size_t chunkSize = _nextSize;
+        while ( chunkSize < required )
+        {
+            chunkSize *= 2;
+        }
+        if ( _nextSize < MAX_CHUNK_SIZE )
+        {
+            _nextSize *= 2;
+        }
+        Chunk* chunk = createChunk(chunkSize);
+        chunk->next = _chunks;
+        _chunks = chunk;
+        _position = (char*)( chunk + 1 );
+        _limit = _position + chunkSize;
+
+        char* result = align(_position, alignment);
+        _position = result + size;
+        _used += size;
+        return result;
+    }
+
+    private: Chunk* createChunk(size_t size)
+    {
+        Chunk* chunk = (Chunk*)::operator new(sizeof(Chunk) + size);
+        chunk->size = size;
+        _reserved += sizeof(Chunk) + size;
+        return chunk;
+    }
+};
+
+}
+
+#endif // !ARENA_H__GLYMPSE__
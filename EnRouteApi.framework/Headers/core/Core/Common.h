@@ -14,11 +14,16 @@ namespace Glympse
  * Implements all methods of ICommon interface. All interfaces on the system extend ICommon.
  * Every class on the system should use this helper to avoid implementing all ICommon methods on its own.
  * Some classes will still decide to override hashCode() and equals(). 
+ *
+ * RefPolicy controls how reference counters are updated (see RefPolicy.h).
+ * Objects confined to a single thread may opt in to ThreadConfinedRefPolicy
+ * to avoid atomic operations altogether.
  */
-template< class T > 
+template< class T, class RefPolicy = AtomicRefPolicy > 
 class Common 
     : public T
     , public virtual CommonStorage
+    , protected RefPolicy
 {
     /**
      * Our constructor. Protected for now since I don't think anyone should
@@ -28,6 +33,10 @@ class Common
     protected: Common() 
         : CommonStorage()
     {
+        // Strong references collectively own one hold, which release() drops after the last of them.
+        // The memory is freed by whichever of the strong and weak sides lets go last, without either
+        // side ever looking at the other counter.
+        _holders = 1;
     }
     
     /**
@@ -43,7 +52,7 @@ class Common
      */
     public: virtual int32 retain()
     {
-        return Concurrent::increment((int32*)&_ref);
+        return RefPolicy::incrementRef(&_ref);
     }
     
     /**
@@ -51,17 +60,14 @@ class Common
      */ 
     public: virtual int32 release()
     {
-        int32 result = Concurrent::decrement((int32*)&_ref);
+        int32 result = RefPolicy::decrementRef(&_ref);
         if ( 0 == result )
         {
-            if ( 0 != _holders )
-            {
-                _attachedObject = NULL;
-            }
-            else
-            {
-                delete this;
-            }
+            // Weak holders keep the memory, but not the object graph. The hold owned by strong
+            // references pins the object while it drops its references.
+            _attachedObject = NULL;
+            dispose();
+            unhold();
         }
         return result;
     }
@@ -71,7 +77,7 @@ class Common
      */
     public: virtual int32 hold()
     {
-        return Concurrent::increment((int32*)&_holders);
+        return RefPolicy::incrementRef(&_holders);
     }
     
     /**
@@ -79,8 +85,8 @@ class Common
      */
     public: virtual int32 unhold()
     {
-        int32 result = Concurrent::decrement((int32*)&_holders);
-        if ( ( 0 == result ) && ( 0 == _ref ) )
+        int32 result = RefPolicy::decrementRef(&_holders);
+        if ( 0 == result )
         {
             delete this;
         }
@@ -88,11 +94,23 @@ class Common
     }
     
     /**
-     * Returns an integer hash code for this object.
+     * Called when the last strong reference is released. Derived classes should drop references
+     * to other objects here, so that those are not kept alive by a dead object. The destructor follows
+     * right away, or once the last weak reference (see W<T>) goes away.
+     *
+     * @note Object::fromThis() must not be used from within this method.
+     */
+    protected: virtual void dispose()
+    {
+    }
+    
+    /**
+     * Returns an integer hash code for this object. Addresses share alignment and high bits,
+     * so they are mixed rather than folded to keep identity keys from clustering.
      */
     public: virtual int32 hashCode()
     {
-        return hashCode((int64)this);
+        return mixHashCode((int64)this);
     }
     
     /**
@@ -110,12 +128,35 @@ class Common
     
     /**
      * Calculates hash code (32-bit value) of 64-bit value.
+     *
+     * @note The prebuilt library compiles this function too (e.g. in Long::hashCode()), so its result
+     * must not change. Use mixHashCode() where the hash never has to match one computed by the library.
      */
     public: static inline int32 hashCode(int64 value)
     {
         return ((int32)(value ^ (value >> 32)));
     }
     
+    /**
+     * Calculates well distributed hash code (32-bit value) of 64-bit value.
+     *
+     * Uses MurmurHash3 64-bit finalizer, so that every input bit affects every output bit.
+     * Plain folding of the halves keeps patterns of the input (aligned pointers, sequential ids)
+     * and makes such keys cluster in hashtables. Results differ from hashCode(int64), so only use
+     * it for hashes that are never compared with ones computed by the prebuilt library: identity hashes
+     * (see hashCode()), which always go through the object's own vtable, and header-side tables.
+     */
+    public: static inline int32 mixHashCode(int64 value)
+    {
+        unsigned long long x = (unsigned long long)value;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return (int32)x;
+    }
+    
     public: virtual void attachObject(const GCommon& obj)
     {
         CommonStorage::attachObject(obj);
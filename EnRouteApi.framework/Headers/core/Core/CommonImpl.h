@@ -10,7 +10,7 @@
 namespace Glympse 
 {
 
-template< class T > GString Common<T>::toString()
+template< class T, class RefPolicy > GString Common<T, RefPolicy>::toString()
 {
     return CoreFactory::createString(typeid(*this).name());
 }
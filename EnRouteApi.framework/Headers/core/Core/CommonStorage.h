@@ -18,6 +18,11 @@ namespace Glympse
  */
 class CommonStorage
 {
+    /**
+     * Weak references need to promote themselves to strong ones.
+     */
+    template< class T > friend class W;
+    
     /**
      * Our private ref count.
      */
@@ -49,6 +54,23 @@ class CommonStorage
     {
         return _attachedObject;
     }
+    
+    /**
+     * Adds a reference to the object, unless it has already lost its last one.
+     *
+     * @return true if reference was added; false otherwise.
+     */
+    protected: inline bool tryRetain()
+    {
+        for ( int32 ref = Concurrent::load(&_ref) ; 0 != ref ; ref = Concurrent::load(&_ref) )
+        {
+            if ( Concurrent::compareAndSwap(&_ref, ref, ref + 1) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 };
     
 }
@@ -27,11 +27,202 @@ class Concurrent
      */    
     public: static int32 decrement(int32* ptr);                
     
+    /**
+     * @name Inline atomic primitives
+     *
+     * Header-level counterparts of increment() and decrement() with explicit memory ordering.
+     * These compile down to a single locked instruction (or LL/SC loop) at the call site
+     * and are meant for hot paths like reference counting.
+     */
+    
+    /**
+     * Atomically adds delta to the variable with relaxed ordering and returns the resulting value.
+     * Suitable for acquiring an additional reference to an object already owned by the caller,
+     * as no other memory accesses need to be ordered around it.
+     */
+    public: static inline int32 addRelaxed(int32* ptr, int32 delta)
+    {
+#if defined(_MSC_VER)
+        return _InterlockedExchangeAdd((volatile long*)ptr, delta) + delta;
+#else
+        return __atomic_add_fetch(ptr, delta, __ATOMIC_RELAXED);
+#endif
+    }
+    
+    /**
+     * Atomically adds delta to the variable with acquire-release ordering and returns the resulting value.
+     * Suitable for dropping a reference: all prior writes to the object become visible to the thread
+     * that observes the counter reaching zero and destroys it.
+     */
+    public: static inline int32 addAcqRel(int32* ptr, int32 delta)
+    {
+#if defined(_MSC_VER)
+        return _InterlockedExchangeAdd((volatile long*)ptr, delta) + delta;
+#else
+        return __atomic_add_fetch(ptr, delta, __ATOMIC_ACQ_REL);
+#endif
+    }
+    
+    /**
+     * Atomically reads the variable with acquire ordering.
+     */
+    public: static inline int32 load(const int32* ptr)
+    {
+#if defined(_MSC_VER)
+        int32 value = *(const volatile int32*)ptr;
+        _ReadWriteBarrier();
+        return value;
+#else
+        return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+    }
+    
+    /**
+     * Pointer flavor of load().
+     */
+    public: template< class T > static inline T* load(T* const* ptr)
+    {
+#if defined(_MSC_VER)
+        T* value = *(T* const volatile*)ptr;
+        _ReadWriteBarrier();
+        return value;
+#else
+        return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+    }
+    
+    /**
+     * Atomically replaces the value of the variable and returns the previous one.
+     * Sequentially consistent.
+     */
+    public: static inline int32 exchange(int32* ptr, int32 value)
+    {
+#if defined(_MSC_VER)
+        return _InterlockedExchange((volatile long*)ptr, value);
+#else
+        return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+#endif
+    }
+    
+    /**
+     * Atomically replaces the value of the variable with desired, if it is equal to expected.
+     * Sequentially consistent.
+     *
+     * @return true if the value was replaced; false otherwise.
+     */
+    public: static inline bool compareAndSwap(int32* ptr, int32 expected, int32 desired)
+    {
+#if defined(_MSC_VER)
+        return ( expected == _InterlockedCompareExchange((volatile long*)ptr, desired, expected) );
+#else
+        return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+    }
+    
+    /**
+     * Pointer flavor of compareAndSwap().
+     */
+    public: template< class T > static inline bool compareAndSwap(T** ptr, T* expected, T* desired)
+    {
+#if defined(_MSC_VER)
+        return ( expected == _InterlockedCompareExchangePointer((void* volatile*)ptr, desired, expected) );
+#else
+        return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+    }
+    
+    /**
+     * Returns an opaque value uniquely identifying the calling thread.
+     * It is only meaningful for comparison against other values returned by this method.
+     */
+    public: static inline const void* getThreadToken()
+    {
+        static thread_local char token;
+        return &token;
+    }
+    
     /**
      * Returns local system UTC time in milliseconds.
      */
     public: static int64 getTime();
     
+    /**
+     * @name Monotonic time
+     *
+     * Unlike getTime(), these clocks never jump (NTP adjustments, user changing system time)
+     * and should be used for measuring intervals.
+     */
+    
+    /**
+     * Returns monotonic time in nanoseconds since an unspecified point in the past.
+     */
+    public: static inline int64 getMonotonicNanos()
+    {
+        return (int64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    /**
+     * Reads raw CPU timer (TSC on x86, virtual counter on ARM64).
+     * Falls back to getMonotonicNanos() on other architectures.
+     * Use getTicksPerSecond() or ticksToNanos() to convert the value.
+     */
+    public: static inline int64 getTicks()
+    {
+#if defined(__aarch64__)
+        int64 ticks;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+        return (int64)__rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return (int64)__builtin_ia32_rdtsc();
+#else
+        return getMonotonicNanos();
+#endif
+    }
+    
+    /**
+     * Returns frequency of getTicks() counter. On x86 it is calibrated against monotonic clock
+     * on first call (takes about a millisecond).
+     */
+    public: static inline int64 getTicksPerSecond()
+    {
+#if defined(__aarch64__)
+        int64 frequency;
+        __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return frequency;
+#elif defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        static int64 frequency = calibrateTicks();
+        return frequency;
+#else
+        return 1000000000LL;
+#endif
+    }
+    
+    /**
+     * Converts difference between two getTicks() values into nanoseconds.
+     */
+    public: static inline int64 ticksToNanos(int64 ticks)
+    {
+        static double nanosPerTick = 1000000000.0 / (double)getTicksPerSecond();
+        return (int64)( (double)ticks * nanosPerTick );
+    }
+    
+    private: static int64 calibrateTicks()
+    {
+        int64 startNanos = getMonotonicNanos();
+        int64 startTicks = getTicks();
+        int64 nanos;
+        do
+        {
+            nanos = getMonotonicNanos() - startNanos;
+        }
+        while ( nanos < 1000000LL );
+        int64 ticks = getTicks() - startTicks;
+        return (int64)( (double)ticks * 1000000000.0 / (double)nanos );
+    }
+    
     /**
      * Background operation is not supported by the platform.
      * Application is completely terminated, once it goes to the background.
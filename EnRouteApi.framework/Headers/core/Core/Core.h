@@ -7,15 +7,40 @@
 #ifndef CORE_H__GLYMPSE__
 #define CORE_H__GLYMPSE__
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <clocale>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
 #include <typeinfo>
+#include <type_traits>
 #include <vector>
 #include <list>
+#include <mutex>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && ( _M_IX86_FP >= 2 ) )
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 #include "Object.h"
 #include "ICommon.h"
 #include "Concurrent.h"
+#include "RefPolicy.h"
+#include "ObjectPool.h"
+#include "Stopwatch.h"
 #include "CommonStorage.h"
 #include "Common.h"
+#include "WeakObject.h"
 #include "CoreConstants.h"
 #include "CC.h"
 #include "IEnumeration.h"
@@ -32,6 +57,7 @@
 #include "IString.h"
 #include "IStringBuilder.h"
 #include "IPrimitive.h"
+#include "FlatHashtable.h"
 #include "IPersistable.h"
 #include "IDrawable.h"
 #include "ILocationProfile.h"
@@ -47,6 +73,18 @@
 #include "IProximityProvider.h"
 #include "ILocationProvider.h"
 #include "CoreFactory.h"
+#include "StringView.h"
+#include "StringBuilder.h"
+#include "StringPool.h"
+#include "JsonParser.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "PrimitiveCodec.h"
+#include "FileStorageUnit.h"
+#include "Arena.h"
+#include "PrimitiveDocument.h"
+#include "PrimitivePath.h"
+#include "PrimitivePatch.h"
 #include "CoreTools.h"
 #include "CommonImpl.h"
 
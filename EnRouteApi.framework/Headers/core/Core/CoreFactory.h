@@ -27,6 +27,17 @@ class CoreFactory
      */
     public: static GString createString(const char* value, int32 length);
     
+    /**
+     * Returns interned string object. All calls with the same contents return the same instance,
+     * which is never freed (see StringPool). Meant for constants like keys and property names.
+     */
+    public: static inline GString internString(const char* value);
+    
+    /**
+     * Returns interned string object.
+     */
+    public: static inline GString internString(const char* value, int32 length);
+    
     /**
      * Creates string builder object with the specified capacity.
      *
@@ -50,6 +61,26 @@ class CoreFactory
      */
     public: static GHashtable<GCommonObj, GCommonObj>::ptr createHashtable();
     
+    /**
+     * Constructs open addressing hashtable (see FlatHashtable) able to hold capacity elements without rehashing.
+     */
+    public: static inline GHashtable<GCommonObj, GCommonObj>::ptr createHashtable(int32 capacity)
+    {
+        return new FlatHashtable<GCommonObj, GCommonObj>(capacity);
+    }
+    
+    /**
+     * Typed flavor of createHashtable(int32). Keys of GString and GLong type are compared
+     * without virtual equals() calls (see HashKeyTraits).
+     * <pre>
+     * GHashtable<GString, GPrimitive>::ptr table = CoreFactory::createHashtable<GString, GPrimitive>(64);
+     * </pre>
+     */
+    public: template< class K, class V > static inline typename GHashtable<K, V>::ptr createHashtable(int32 capacity)
+    {
+        return new FlatHashtable<K, V>(capacity);
+    }
+    
     /**
      * Constructs a storage object.
      */
@@ -46,6 +46,135 @@ class CoreTools
      * Decodes a URL-encoded string.
      */
     public: static GString urlDecode(const GString& str);
+
+/*C*/
+    /**
+     * @name String View Overloads
+     *
+     * Accept StringView, so that callers holding a substring or a trimmed view do not need
+     * to materialize an intermediate string first.
+     */
+
+    /**
+     * Parses JSON text into GPrimitive object using JsonParser. Returns NULL if the text is not valid JSON.
+     */
+    public: static GPrimitive stringToPrimitive(const StringView& json)
+    {
+        return JsonParser::parse(json);
+    }
+
+    /**
+     * Parses JSON text into PrimitiveDocument. Returns NULL if the text is not valid JSON.
+     *
+     * The whole tree is allocated in a single arena and released at once, which suits large responses
+     * that are mostly read. Unlike trees returned by stringToPrimitive(), the document stores copies of
+     * primitives put into it: changes made to a CoreFactory primitive after it was put are not seen by
+     * the document. Memory of replaced values is only reclaimed with the document (see PrimitiveDocument).
+     * Reads cache string objects in the document, so it must not be shared between threads without
+     * external locking.
+     */
+    public: static GPrimitive stringToDocument(const StringView& json)
+    {
+        return PrimitiveDocument::parse(json);
+    }
+
+    /**
+     * Parses JSON text into PrimitiveDocument which builds containers only when they are first accessed
+     * (see PrimitiveDocument::parseLazy()). Suits large responses of which only a few fields are read.
+     * The string is kept by the document instead of being copied.
+     *
+     * @note Reading the result builds containers, so even read-only calls (get(), size(), PrimitivePath
+     * lookups) modify it. The result must not be shared between threads without external locking;
+     * use stringToPrimitive() for trees that are read from several threads.
+     */
+    public: static GPrimitive stringToPrimitiveLazy(const GString& json)
+    {
+        return PrimitiveDocument::parseLazy(json);
+    }
+
+    /**
+     * Streams JSON text into handler without building GPrimitive tree. Use JsonReader directly
+     * to feed the text in chunks as it arrives.
+     *
+     * @return true if the whole document was read, false if it is malformed or the handler stopped early.
+     */
+    public: static bool readJson(const StringView& json, JsonHandler& handler)
+    {
+        JsonReader reader;
+        reader.feed(json);
+        reader.finish();
+        return JsonReader::TOKEN_END_DOCUMENT == reader.dispatch(handler);
+    }
+
+    /**
+     * Writes data as JSON into sink without building the string in memory. The output is flushed
+     * into the sink before returning.
+     */
+    public: static void writeJson(const GPrimitive& data, JsonSink& sink)
+    {
+        JsonWriter writer(sink);
+        writer.value(data);
+        writer.flush();
+    }
+
+    /**
+     * Convert http method string to enum. Comparison is case insensitive.
+     */
+    public: static int32 httpMethodStringToEnum(const StringView& methodString)
+    {
+        if ( methodString.equalsIgnoreCase("GET") )
+        {
+            return CC::HTTP_METHOD_GET;
+        }
+        else if ( methodString.equalsIgnoreCase("POST") )
+        {
+            return CC::HTTP_METHOD_POST;
+        }
+        else if ( methodString.equalsIgnoreCase("PUT") )
+        {
+            return CC::HTTP_METHOD_PUT;
+        }
+        else if ( methodString.equalsIgnoreCase("DELETE") )
+        {
+            return CC::HTTP_METHOD_DELETE;
+        }
+        return CC::HTTP_METHOD_DEFAULT;
+    }
+
+    /**
+     * Translates string into URL-encoded format. Strings consisting only of characters that
+     * never need escaping are copied directly.
+     */
+    public: static GString urlEncode(const StringView& str)
+    {
+        for ( const char* ch = str.begin() ; ch != str.end() ; ++ch )
+        {
+            if ( !isUrlSafe(*ch) )
+            {
+                return urlEncode(str.toString());
+            }
+        }
+        return str.toString();
+    }
+
+    /**
+     * Decodes a URL-encoded string. Strings without escape sequences are copied directly.
+     */
+    public: static GString urlDecode(const StringView& str)
+    {
+        if ( str.contains('%') || str.contains('+') )
+        {
+            return urlDecode(str.toString());
+        }
+        return str.toString();
+    }
+
+    private: static bool isUrlSafe(char ch)
+    {
+        return ( ( ch >= 'a' ) && ( ch <= 'z' ) ) || ( ( ch >= 'A' ) && ( ch <= 'Z' ) ) ||
+            ( ( ch >= '0' ) && ( ch <= '9' ) ) || ( '-' == ch ) || ( '_' == ch ) || ( '.' == ch );
+    }
+/**/
 };
 
 }
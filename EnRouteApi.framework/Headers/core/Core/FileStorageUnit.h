@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FILESTORAGEUNIT_H__GLYMPSE__
+#define FILESTORAGEUNIT_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Storage unit persisting primitives in a file at the specified path.
+ *
+ * Data is saved in the binary format of PrimitiveCodec. load() detects the format of the file, so files
+ * written as JSON (e.g. by earlier versions) are still loaded, and are converted on the next save().
+ * Saving writes a temporary file first and then renames it over the target, so a crash never leaves
+ * a partially written file behind.
+ */
+/*O*public**/ class FileStorageUnit : public Common< IStorageUnit >
+{
+    private: StringBuilder _path;
+
+    public: FileStorageUnit(const StringView& path)
+    {
+        _path.append(path);
+    }
+
+    /**
+     * IStorageUnit section
+     */
+
+    public: virtual void save(const GPrimitive& data)
+    {
+        StringBuilder encoded(4096);
+        PrimitiveCodec::encode(data, encoded);
+
+        StringBuilder temporary;
+        temporary.append(_path).append(".tmp");
+        FILE* file = fopen(temporary.c_str(), "wb");
+        if ( NULL == file )
+        {
+            return;
+        }
+        bool written = ( fwrite(encoded.data(), 1, encoded.length(), file) == (size_t)encoded.length() );
+        written = ( 0 == fclose(file) ) && written;
+        if ( written )
+        {
+            written = ( 0 == rename(temporary.c_str(), _path.c_str()) );
+        }
+        if ( !written )
+        {
+            ::remove(temporary.c_str());
+        }
+    }
+
+    public: virtual GPrimitive load()
+    {
+        FILE* file = fopen(_path.c_str(), "rb");
+        if ( NULL == file )
+        {
+            return NULL;
+        }
+        std::vector<char> contents;
+        char block[4096];
+        size_t count;
+        while ( ( count = fread(block, 1, sizeof(block), file) ) > 0 )
+        {
+            contents.insert(contents.end(), block, block + count);
+        }
+        fclose(file);
+        if ( contents.empty() )
+        {
+            return NULL;
+        }
+        return PrimitiveCodec::decodeAny(&contents[0], (int32)contents.size());
+    }
+
+    public: virtual void remove()
+    {
+        ::remove(_path.c_str());
+    }
+};
+
+}
+
+#endif // !FILESTORAGEUNIT_H__GLYMPSE__
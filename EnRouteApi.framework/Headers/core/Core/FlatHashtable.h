@@ -0,0 +1,404 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef FLATHASHTABLE_H__GLYMPSE__
+#define FLATHASHTABLE_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Defines how FlatHashtable hashes and compares keys. The generic version relies on
+ * ICommon::hashCode() and ICommon::equals(), specializations below avoid virtual equals()
+ * for the most common key types.
+ */
+template< class K > struct HashKeyTraits
+{
+    static inline int32 hash(const K& key)
+    {
+        return key->hashCode();
+    }
+
+    static inline bool equals(const K& lhs, const K& rhs)
+    {
+        return ( lhs == rhs ) || lhs->equals(rhs);
+    }
+};
+
+template<> struct HashKeyTraits< GString >
+{
+    static inline int32 hash(const GString& key)
+    {
+        return key->hashCode();
+    }
+
+    static inline bool equals(const GString& lhs, const GString& rhs)
+    {
+        if ( lhs == rhs )
+        {
+            return true;
+        }
+        int32 length = lhs->length();
+        return ( length == rhs->length() ) && ( 0 == memcmp(lhs->getBytes(), rhs->getBytes(), length) );
+    }
+};
+
+template<> struct HashKeyTraits< GLong >
+{
+    static inline int32 hash(const GLong& key)
+    {
+        return Common< ILong >::mixHashCode(key->longValue());
+    }
+
+    static inline bool equals(const GLong& lhs, const GLong& rhs)
+    {
+        return ( lhs == rhs ) || ( lhs->longValue() == rhs->longValue() );
+    }
+};
+
+/**
+ * Open addressing hashtable with Robin Hood probing.
+ *
+ * Hashes, keys and values are kept in separate arrays. Key hashes are computed once on insertion
+ * and cached, so lookups only call into keys (HashKeyTraits::equals()) when cached hashes match.
+ * Removal uses backward shift, so the table never accumulates tombstones.
+ *
+ * NULL keys are not supported (put() ignores them, get() returns NULL).
+ */
+template< class K, class V, class Traits = HashKeyTraits< K > >
+class FlatHashtable : public Common< IHashtable< K, V > >
+{
+    /**
+     * Marks occupied slots, so that 0 can denote an empty one.
+     */
+    private: static const unsigned int OCCUPIED = 0x80000000u;
+
+    private: static const int32 MIN_CAPACITY = 8;
+
+    private: static const int32 MAX_CAPACITY = 0x40000000;
+
+    private: std::vector< unsigned int > _hashes;
+
+    private: std::vector< K > _keys;
+
+    private: std::vector< V > _values;
+
+    private: int32 _size;
+
+    private: int32 _shift;
+
+    private: float _maxLoadFactor;
+
+    private: int32 _threshold;
+
+    /**
+     * Creates hashtable able to hold capacity elements without rehashing.
+     * See setMaxLoadFactor() for the accepted range of maxLoadFactor.
+     */
+    public: FlatHashtable(int32 capacity = 0, float maxLoadFactor = 0.8f)
+        : _size(0)
+        , _shift(32)
+        , _maxLoadFactor(clampLoadFactor(maxLoadFactor))
+        , _threshold(0)
+    {
+        reserve(capacity);
+    }
+
+    /**
+     * @name Capacity
+     */
+
+    /**
+     * Makes sure that count elements fit into the table without rehashing.
+     */
+    public: void reserve(int32 count)
+    {
+        int32 slots = MIN_CAPACITY;
+        while ( ( (float)count > (float)slots * _maxLoadFactor ) && ( slots < MAX_CAPACITY ) )
+        {
+            slots *= 2;
+        }
+        if ( slots > (int32)_hashes.size() )
+        {
+            rehash(slots);
+        }
+    }
+
+    /**
+     * Sets maximum ratio of occupied slots. Higher values save memory at the cost of longer probes.
+     * Takes effect on the next growth. Values are clamped to [0.25, 0.95]: the table must
+     * always keep free slots to terminate probing, and sparser tables only waste memory.
+     */
+    public: void setMaxLoadFactor(float maxLoadFactor)
+    {
+        _maxLoadFactor = clampLoadFactor(maxLoadFactor);
+        _threshold = (int32)( (float)_hashes.size() * _maxLoadFactor );
+    }
+
+    /**
+     * Returns number of slots currently allocated.
+     */
+    public: int32 capacity()
+    {
+        return (int32)_hashes.size();
+    }
+
+    /**
+     * @name IHashtable section
+     */
+
+    public: virtual void put(const K& key, const V& value)
+    {
+        if ( NULL == key )
+        {
+            return;
+        }
+        unsigned int hash = prepare(Traits::hash(key));
+        int32 index = find(key, hash);
+        if ( index >= 0 )
+        {
+            _values[index] = value;
+            return;
+        }
+        if ( _size + 1 > _threshold )
+        {
+            rehash(_hashes.empty() ? MIN_CAPACITY : (int32)_hashes.size() * 2);
+        }
+        K carriedKey(key);
+        V carriedValue(value);
+        place(hash, carriedKey, carriedValue);
+        ++_size;
+    }
+
+    public: virtual void remove(const K& key)
+    {
+        if ( NULL == key )
+        {
+            return;
+        }
+        int32 index = find(key, prepare(Traits::hash(key)));
+        if ( index < 0 )
+        {
+            return;
+        }
+
+        // Shift following displaced elements one slot back.
+        int32 mask = (int32)_hashes.size() - 1;
+        int32 next = ( index + 1 ) & mask;
+        while ( ( 0 != _hashes[next] ) && ( 0 != distance(next) ) )
+        {
+            _hashes[index] = _hashes[next];
+            _keys[index].swap(_keys[next]);
+            _values[index].swap(_values[next]);
+            index = next;
+            next = ( next + 1 ) & mask;
+        }
+        _hashes[index] = 0;
+        _keys[index].reset();
+        _values[index].reset();
+        --_size;
+    }
+
+    public: virtual void clear()
+    {
+        int32 slots = (int32)_hashes.size();
+        for ( int32 i = 0 ; i < slots ; ++i )
+        {
+            _hashes[i] = 0;
+            _keys[i].reset();
+            _values[i].reset();
+        }
+        _size = 0;
+    }
+
+    /**
+     * @name IMap section
+     */
+
+    public: virtual V get(const K& key)
+    {
+        if ( NULL == key )
+        {
+            return V();
+        }
+        int32 index = find(key, prepare(Traits::hash(key)));
+        return ( index >= 0 ) ? _values[index] : V();
+    }
+
+    public: virtual bool containsKey(const K& key)
+    {
+        return ( NULL != key ) && ( find(key, prepare(Traits::hash(key))) >= 0 );
+    }
+
+    public: virtual bool containsValue(const V& value)
+    {
+        int32 slots = (int32)_hashes.size();
+        for ( int32 i = 0 ; i < slots ; ++i )
+        {
+            if ( ( 0 != _hashes[i] ) && ( ( _values[i] == value ) ||
+                ( ( NULL != _values[i] ) && _values[i]->equals(value) ) ) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    public: virtual typename GEnumeration< K >::ptr keys()
+    {
+        KeyEnumeration* enumeration = new KeyEnumeration();
+        enumeration->_keys.reserve(_size);
+        int32 slots = (int32)_hashes.size();
+        for ( int32 i = 0 ; i < slots ; ++i )
+        {
+            if ( 0 != _hashes[i] )
+            {
+                enumeration->_keys.push_back(_keys[i]);
+            }
+        }
+        return enumeration;
+    }
+
+    public: virtual int32 size()
+    {
+        return _size;
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static inline float clampLoadFactor(float maxLoadFactor)
+    {
+        // Negated comparison also catches NaN.
+        if ( !( maxLoadFactor >= 0.25f ) )
+        {
+            return 0.25f;
+        }
+        return ( maxLoadFactor > 0.95f ) ? 0.95f : maxLoadFactor;
+    }
+
+    private: static inline unsigned int prepare(int32 hash)
+    {
+        return (unsigned int)hash | OCCUPIED;
+    }
+
+    /**
+     * Fibonacci hashing spreads the bits of the hash across the index range.
+     */
+    private: inline int32 home(unsigned int hash) const
+    {
+        return (int32)( ( hash * 2654435769u ) >> _shift );
+    }
+
+    private: inline int32 distance(int32 index) const
+    {
+        return ( index - home(_hashes[index]) ) & ( (int32)_hashes.size() - 1 );
+    }
+
+    private: int32 find(const K& key, unsigned int hash) const
+    {
+        if ( 0 == _size )
+        {
+            return -1;
+        }
+        int32 mask = (int32)_hashes.size() - 1;
+        for ( int32 index = home(hash), probe = 0 ; ; index = ( index + 1 ) & mask, ++probe )
+        {
+            unsigned int current = _hashes[index];
+            if ( ( 0 == current ) || ( distance(index) < probe ) )
+            {
+                return -1;
+            }
+            if ( ( current == hash ) && Traits::equals(_keys[index], key) )
+            {
+                return index;
+            }
+        }
+    }
+
+    /**
+     * Inserts element known to be absent. Elements closer to their home slot give way to
+     * the carried one (Robin Hood), which keeps probe lengths short and uniform.
+     */
+    private: void place(unsigned int hash, K& key, V& value)
+    {
+        int32 mask = (int32)_hashes.size() - 1;
+        for ( int32 index = home(hash), probe = 0 ; ; index = ( index + 1 ) & mask, ++probe )
+        {
+            if ( 0 == _hashes[index] )
+            {
+                _hashes[index] = hash;
+                _keys[index].swap(key);
+                _values[index].swap(value);
+                return;
+            }
+            int32 existing = distance(index);
+            if ( existing < probe )
+            {
+                std::swap(_hashes[index], hash);
+                _keys[index].swap(key);
+                _values[index].swap(value);
+                probe = existing;
+            }
+        }
+    }
+
+    private: void rehash(int32 slots)
+    {
+        std::vector< unsigned int > hashes(slots, 0);
+        std::vector< K > keys(slots);
+        std::vector< V > values(slots);
+        hashes.swap(_hashes);
+        keys.swap(_keys);
+        values.swap(_values);
+
+        _shift = 32;
+        for ( int32 i = slots ; i > 1 ; i >>= 1 )
+        {
+            --_shift;
+        }
+        _threshold = (int32)( (float)slots * _maxLoadFactor );
+
+        int32 count = (int32)hashes.size();
+        for ( int32 i = 0 ; i < count ; ++i )
+        {
+            if ( 0 != hashes[i] )
+            {
+                place(hashes[i], keys[i], values[i]);
+            }
+        }
+    }
+
+    /**
+     * Enumerates snapshot of the keys, so that the table can be modified during enumeration.
+     */
+    private: class KeyEnumeration : public Common< IEnumeration< K > >
+    {
+        public: std::vector< K > _keys;
+
+        private: int32 _position;
+
+        public: KeyEnumeration()
+            : _position(0)
+        {
+        }
+
+        public: virtual bool hasMoreElements()
+        {
+            return _position < (int32)_keys.size();
+        }
+
+        public: virtual K nextElement()
+        {
+            return _keys[_position++];
+        }
+    };
+};
+
+}
+
+#endif // !FLATHASHTABLE_H__GLYMPSE__
@@ -47,6 +47,19 @@ template< class T > class GArray
      */
     public: virtual typename GArray<T>::ptr clone() = 0;
     
+    /*C*/
+    /**
+     * Copies count elements starting at start into out.
+     */
+    public: inline void copyTo(T* out, int32 start, int32 count)
+    {
+        for ( int32 i = 0 ; i < count ; ++i )
+        {
+            out[i] = at(start + i);
+        }
+    }
+    /**/
+    
     /**
      * Defines type of elements stored in the collection.
      */
@@ -60,7 +73,7 @@ template< class T > class GArray
  */
 /*C*/
 
-/// Wraps IEnumeration into forward iterator.
+/// Wraps IEnumeration into forward iterator. Used for containers without random access (IList).
 template< typename T > struct RangeIterator
 {
     private: typename GEnumeration<T>::ptr _elements;
@@ -72,7 +85,7 @@ template< typename T > struct RangeIterator
         , _position(position)
         , _current()
     {
-        if ( _elements->hasMoreElements() )
+        if ( ( _elements != NULL ) && _elements->hasMoreElements() )
         {
             _current = _elements->nextElement();
         }
@@ -98,17 +111,172 @@ template< typename T > struct RangeIterator
         return _position != other._position;
     }
 };
+
+/// Random access iterator over IArray. Does not allocate and does not retain the array,
+/// so the array must outlive the iterator (which is always the case in range-based for loops).
+template< typename T > struct ArrayIterator
+{
+    public: typedef std::random_access_iterator_tag iterator_category;
+    public: typedef T value_type;
+    public: typedef std::ptrdiff_t difference_type;
+    public: typedef const T* pointer;
+    public: typedef T reference;
+    
+    private: IArray<T>* _array;
+    private: int32 _index;
+    
+    public: ArrayIterator()
+        : _array(NULL)
+        , _index(0)
+    {
+    }
+    
+    public: ArrayIterator(IArray<T>* array, int32 index)
+        : _array(array)
+        , _index(index)
+    {
+    }
+    
+    public: T operator*() const
+    {
+        return _array->at(_index);
+    }
+    
+    public: T operator[](difference_type offset) const
+    {
+        return _array->at(_index + (int32)offset);
+    }
+    
+    public: ArrayIterator<T>& operator++()
+    {
+        ++_index;
+        return *this;
+    }
+    
+    public: ArrayIterator<T> operator++(int)
+    {
+        ArrayIterator<T> result(*this);
+        ++_index;
+        return result;
+    }
+    
+    public: ArrayIterator<T>& operator--()
+    {
+        --_index;
+        return *this;
+    }
+    
+    public: ArrayIterator<T> operator--(int)
+    {
+        ArrayIterator<T> result(*this);
+        --_index;
+        return result;
+    }
+    
+    public: ArrayIterator<T>& operator+=(difference_type offset)
+    {
+        _index += (int32)offset;
+        return *this;
+    }
+    
+    public: ArrayIterator<T>& operator-=(difference_type offset)
+    {
+        _index -= (int32)offset;
+        return *this;
+    }
+    
+    public: ArrayIterator<T> operator+(difference_type offset) const
+    {
+        return ArrayIterator<T>(_array, _index + (int32)offset);
+    }
+    
+    public: ArrayIterator<T> operator-(difference_type offset) const
+    {
+        return ArrayIterator<T>(_array, _index - (int32)offset);
+    }
+    
+    public: difference_type operator-(const ArrayIterator<T>& other) const
+    {
+        return _index - other._index;
+    }
+    
+    public: bool operator==(const ArrayIterator<T>& other) const
+    {
+        return _index == other._index;
+    }
+    
+    public: bool operator!=(const ArrayIterator<T>& other) const
+    {
+        return _index != other._index;
+    }
+    
+    public: bool operator<(const ArrayIterator<T>& other) const
+    {
+        return _index < other._index;
+    }
+    
+    public: bool operator>(const ArrayIterator<T>& other) const
+    {
+        return _index > other._index;
+    }
+    
+    public: bool operator<=(const ArrayIterator<T>& other) const
+    {
+        return _index <= other._index;
+    }
+    
+    public: bool operator>=(const ArrayIterator<T>& other) const
+    {
+        return _index >= other._index;
+    }
+};
+
+template< typename T > inline ArrayIterator<T> operator+(typename ArrayIterator<T>::difference_type offset, const ArrayIterator<T>& iterator)
+{
+    return iterator + offset;
+}
+
+/// Picks iterator type for the container: index based for arrays, enumeration based for everything else.
+template< typename T, bool IsArray = std::is_base_of< IArray< typename T::Element >, T >::value > struct RangeSelector
+{
+    typedef RangeIterator< typename T::Element > Iterator;
+    
+    static inline Iterator begin(const O<T>& container)
+    {
+        return Iterator(container->elements(), 0);
+    }
+    
+    static inline Iterator end(const O<T>& container)
+    {
+        return Iterator(NULL, container->length());
+    }
+};
+
+template< typename T > struct RangeSelector< T, true >
+{
+    typedef ArrayIterator< typename T::Element > Iterator;
+    
+    static inline Iterator begin(const O<T>& container)
+    {
+        return Iterator(container.get(), 0);
+    }
+    
+    static inline Iterator end(const O<T>& container)
+    {
+        return Iterator(container.get(), container->length());
+    }
+};
     
 // Provides standalone begin() function for ADL.
-template< typename T > RangeIterator< typename T::Element > begin(const O<T>& container)
+template< typename T > typename RangeSelector<T>::Iterator begin(const O<T>& container)
 {
-    return RangeIterator< typename T::Element >(container->elements(), 0);
+    return RangeSelector<T>::begin(container);
 }
    
 // Provides standalone end() function for ADL.
-template< typename T > RangeIterator< typename T::Element > end(const O<T>& container)
+template< typename T > typename RangeSelector<T>::Iterator end(const O<T>& container)
 {
-    return RangeIterator< typename T::Element >(container->elements(), container->length());
+    return RangeSelector<T>::end(container);
 }
 /**/
     
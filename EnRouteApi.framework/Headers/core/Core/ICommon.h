@@ -32,6 +32,10 @@ struct ICommon;
 typedef O< ICommon > GCommon;
 typedef GCommon GCommonObj;
 
+// Smart pointers are passed by value across the boundary with the prebuilt library.
+// Their layout (vtable pointer followed by the object pointer) must not change.
+static_assert(sizeof(GCommon) == 2 * sizeof(ICommon*), "O<T> layout is shared with the prebuilt library");
+
 // Preliminary IString declaration.
 struct IString;    
 typedef O< IString > GString;   
@@ -14,6 +14,8 @@ namespace Glympse
  * Type for Unicode characters.
  */
 typedef unsigned short unichar;
+
+/*C*/class StringView;/**/
     
 /**
  * An immutable sequence of characters/code units. A string is represented by array of UTF-8 values.
@@ -261,6 +263,31 @@ struct IString : public ICommon
      * See getBytes() for more details. 
      */     
     public: virtual const char* toCharArray() = 0;    
+
+/*C*/
+    /**
+     * @name Views
+     *
+     * Non-allocating access to the contents of this string. The returned views point into this string
+     * and must not outlive it. See StringView for details.
+     */
+
+    /**
+     * Returns the view of all characters of this string.
+     */
+    public: inline StringView view();
+
+    /**
+     * Returns the view of characters in [start, end).
+     */
+    public: inline StringView view(int32 start, int32 end);
+
+    /**
+     * Returns the view of this string with white space removed from both ends. Same as trim(),
+     * but does not create a new string.
+     */
+    public: inline StringView trimmedView();
+/**/
 };
         
 }
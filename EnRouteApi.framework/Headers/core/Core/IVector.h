@@ -39,6 +39,60 @@ template< class T > struct IVector : public IArray< T >
     public: virtual T lastElement() = 0;
     
     public: virtual void sort(const typename GComparator<T>::ptr& comparator) = 0;
+    
+    /*C*/
+    /**
+     * Appends count elements from items. Capacity is reserved once for the whole batch.
+     */
+    public: inline void addAll(const T* items, int32 count)
+    {
+        ensureCapacity(size() + count);
+        for ( int32 i = 0 ; i < count ; ++i )
+        {
+            addElement(items[i]);
+        }
+    }
+    
+    /**
+     * Appends all elements of another array. Capacity is reserved once for the whole batch.
+     */
+    public: inline void addAll(const typename GArray<T>::ptr& items)
+    {
+        insertAll(items, size());
+    }
+    
+    /**
+     * Inserts all elements of another array at the specified location.
+     * Capacity is reserved once for the whole batch and every displaced element is moved once,
+     * so the cost is linear in the number of inserted and displaced elements.
+     */
+    public: inline void insertAll(const typename GArray<T>::ptr& items, int32 location)
+    {
+        // Inserting vector into itself would shift the elements being read.
+        typename GArray<T>::ptr source = ( items.get() == static_cast< IArray<T>* >(this) ) ? items->clone() : items;
+        int32 count = source->length();
+        int32 length = size();
+        ensureCapacity(length + count);
+        
+        // Slots past the current end receive their final values right away: either the tail of the batch
+        // or elements displaced by it.
+        for ( int32 i = length ; i < length + count ; ++i )
+        {
+            addElement(( i < location + count ) ? source->at(i - location) : elementAt(i - count));
+        }
+        
+        // Remaining displaced elements move back by count, last one first. The batch then fills the gap.
+        for ( int32 i = length - 1 ; i >= location + count ; --i )
+        {
+            setElementAt(elementAt(i - count), i);
+        }
+        int32 end = ( location + count < length ) ? location + count : length;
+        for ( int32 i = location ; i < end ; ++i )
+        {
+            setElementAt(source->at(i - location), i);
+        }
+    }
+    /**/
 };
     
 template< class T > class GVector
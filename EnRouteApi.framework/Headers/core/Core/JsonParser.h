@@ -0,0 +1,1205 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef JSONPARSER_H__GLYMPSE__
+#define JSONPARSER_H__GLYMPSE__
+
+#if defined(__AVX2__)
+#define JSONPARSER_AVX2__GLYMPSE__
+#elif defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && ( _M_IX86_FP >= 2 ) )
+#define JSONPARSER_SSE2__GLYMPSE__
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define JSONPARSER_NEON__GLYMPSE__
+#endif
+
+namespace Glympse
+{
+
+/**
+ * Two stage JSON parser producing GPrimitive trees.
+ *
+ * Stage 1 classifies the input 64 bytes at a time with SIMD instructions (AVX2 or SSE2 on x86, NEON on ARM64,
+ * with a portable scalar fallback) and produces an index of all structural characters ({ } [ ] : , and quotes)
+ * that lie outside of strings. Escaped quotes are resolved with carry arithmetic and string regions with
+ * a prefix XOR, so the input is never inspected character by character in this stage.
+ *
+ * Stage 2 walks the index and builds the tree. Strings without escape sequences are copied in one go,
+ * repeated object keys share a single string object, and numbers are converted without going through
+ * the C library whenever the result is exact.
+ *
+ * Numbers without fraction and exponent that fit into 64 bits become CC::PRIMITIVE_TYPE_LONG primitives,
+ * all other numbers become CC::PRIMITIVE_TYPE_DOUBLE.
+ *
+ * Builders may defer nested containers. Deferred containers are validated in stage 2 but not built; the
+ * structural index, extended with the positions of all containers, lets them be built later without
+ * scanning the text again.
+ */
+class JsonParser
+{
+    /**
+     * Maximum nesting depth of arrays and objects. Deeper documents are rejected.
+     */
+    public: static const int32 MAX_DEPTH = 1024;
+
+    /**
+     * Parses JSON text. Returns NULL if the text is not a valid JSON document.
+     */
+    public: static GPrimitive parse(const char* json, int32 length)
+    {
+        PrimitiveTreeBuilder builder;
+        GPrimitive result;
+        return parse(json, length, builder, result) ? result : GPrimitive();
+    }
+
+    /**
+     * This method is provided for convenience.
+     * See parse(const char*, int32) for more details.
+     */
+    public: static GPrimitive parse(const StringView& json)
+    {
+        return parse(json.data(), json.length());
+    }
+
+    /**
+     * Parses JSON text into a tree created by builder. parse(const char*, int32) uses it to build GPrimitive
+     * trees, PrimitiveDocument to build nodes in its arena. Builder provides:
+     *
+     * - Value and Key types (default constructible and copyable);
+     * - Value createContainer(bool isObject);
+     * - Key createKey(const char* chars, int32 length);
+     * - Value createString(const char* chars, int32 length);
+     * - Value createLong(int64 value), createDouble(double value), createBool(bool value) and createNull();
+     * - void add(Value& object, const Key& key, const Value& value) and void add(Value& array, const Value& value);
+     * - void finish(Value& container), called when the closing bracket of a container is reached;
+     * - bool defer(int32 level), asked before every container nested in the root (level 2 and deeper);
+     * - Value createDeferred(bool isObject, int32 container), called for containers the builder deferred.
+     *
+     * Strings are passed without quotes and with escape sequences decoded. The characters are only valid
+     * for the duration of the call.
+     *
+     * Deferred containers are validated but not built. They can be built later with
+     * parse(const char*, int32, Index&, int32, Builder&, Value&), which needs the structural index of
+     * the text. Builders that never defer can use this method; others need the overload taking Index.
+     *
+     * @return true if the text is a valid JSON document. The root is stored in result.
+     */
+    public: template< class Builder > static bool parse(const char* json, int32 length, Builder& builder,
+        typename Builder::Value& result)
+    {
+        Index index;
+        JsonParser parser(json, length, index);
+        return parser.index() && parser.build(builder, result, 0, true);
+    }
+
+    /**
+     * Structural index of JSON text, kept by callers that build deferred containers later.
+     */
+    public: struct Index
+    {
+        /**
+         * Location of a container in structurals.
+         */
+        struct Container
+        {
+            /**
+             * Positions of the opening and the closing bracket.
+             */
+            int32 open;
+            int32 close;
+
+            /**
+             * Number of the first container following this one and all containers nested in it.
+             */
+            int32 next;
+        };
+
+        /**
+         * Offsets of structural characters.
+         */
+        std::vector< int32 > structurals;
+
+        /**
+         * All containers reached so far, in the order of their opening brackets.
+         */
+        std::vector< Container > containers;
+    };
+
+    /**
+     * This method is provided for builders deferring containers.
+     * See parse(const char*, int32, Builder&, Value&) for more details. The structural index of the text
+     * is stored in index.
+     */
+    public: template< class Builder > static bool parse(const char* json, int32 length, Builder& builder,
+        typename Builder::Value& result, Index& index)
+    {
+        JsonParser parser(json, length, index);
+        parser._keepsContainers = true;
+        return parser.index() && parser.build(builder, result, 0, true);
+    }
+
+    /**
+     * Builds container deferred by an earlier call to parse(const char*, int32, Builder&, Value&, Index&).
+     * The text must be the same. Containers nested in it are offered to the builder for deferral again
+     * and skipped in constant time if deferred.
+     *
+     * @param container Value passed to createDeferred() for the container.
+     */
+    public: template< class Builder > static bool parse(const char* json, int32 length, Index& index,
+        int32 container, Builder& builder, typename Builder::Value& result)
+    {
+        JsonParser parser(json, length, index);
+        parser._keepsContainers = true;
+        parser._container = container;
+        parser._next = index.containers[container].open;
+        parser._position = index.structurals[parser._next];
+        return parser.build(builder, result, 0, false);
+    }
+
+    /**
+     * @name Internals
+     */
+
+    /**
+     * Builder of GPrimitive trees. Repeated object keys share a single string object.
+     */
+    private: class PrimitiveTreeBuilder
+    {
+        public: typedef GPrimitive Value;
+
+        public: typedef GString Key;
+
+        private: static const int32 KEY_CACHE_SIZE = 256;
+
+        private: struct KeyCacheEntry
+        {
+            unsigned int hash;
+            GString key;
+        };
+
+        private: KeyCacheEntry _keys[KEY_CACHE_SIZE];
+
+        public: GPrimitive createContainer(bool isObject)
+        {
+            return CoreFactory::createPrimitive(isObject ? CC::PRIMITIVE_TYPE_OBJECT : CC::PRIMITIVE_TYPE_ARRAY);
+        }
+
+        public: GString createKey(const char* chars, int32 length)
+        {
+            unsigned int hash = hashKey(chars, length);
+            KeyCacheEntry& entry = _keys[hash & ( KEY_CACHE_SIZE - 1 )];
+            if ( ( entry.key != NULL ) && ( entry.hash == hash ) && ( entry.key->length() == length ) &&
+                ( 0 == memcmp(entry.key->getBytes(), chars, length) ) )
+            {
+                return entry.key;
+            }
+            entry.hash = hash;
+            entry.key = CoreFactory::createString(chars, length);
+            return entry.key;
+        }
+
+        public: GPrimitive createString(const char* chars, int32 length)
+        {
+            return CoreFactory::createPrimitive(CoreFactory::createString(chars, length));
+        }
+
+        public: GPrimitive createLong(int64 value)
+        {
+            return CoreFactory::createPrimitive(value);
+        }
+
+        public: GPrimitive createDouble(double value)
+        {
+            return CoreFactory::createPrimitive(value);
+        }
+
+        public: GPrimitive createBool(bool value)
+        {
+            return CoreFactory::createPrimitive(value);
+        }
+
+        public: GPrimitive createNull()
+        {
+            return CoreFactory::createPrimitive();
+        }
+
+        public: void add(GPrimitive& object, const GString& key, const GPrimitive& value)
+        {
+            object->put(key, value);
+        }
+
+        public: void add(GPrimitive& array, const GPrimitive& value)
+        {
+            array->put(value);
+        }
+
+        public: void finish(GPrimitive&)
+        {
+        }
+
+        public: bool defer(int32)
+        {
+            return false;
+        }
+
+        public: GPrimitive createDeferred(bool, int32)
+        {
+            return NULL;
+        }
+    };
+
+    /**
+     * Builder creating nothing. Used to validate deferred containers.
+     */
+    private: class Validator
+    {
+        public: typedef bool Value;
+
+        public: typedef bool Key;
+
+        public: bool createContainer(bool)
+        {
+            return false;
+        }
+
+        public: bool createKey(const char*, int32)
+        {
+            return false;
+        }
+
+        public: bool createString(const char*, int32)
+        {
+            return false;
+        }
+
+        public: bool createLong(int64)
+        {
+            return false;
+        }
+
+        public: bool createDouble(double)
+        {
+            return false;
+        }
+
+        public: bool createBool(bool)
+        {
+            return false;
+        }
+
+        public: bool createNull()
+        {
+            return false;
+        }
+
+        public: void add(bool&, bool, bool)
+        {
+        }
+
+        public: void add(bool&, bool)
+        {
+        }
+
+        public: void finish(bool&)
+        {
+        }
+
+        public: bool defer(int32)
+        {
+            return false;
+        }
+
+        public: bool createDeferred(bool, int32)
+        {
+            return false;
+        }
+    };
+
+    private: template< class Builder > struct Frame
+    {
+        typename Builder::Value container;
+        typename Builder::Key key;
+        int32 number;
+        bool isObject;
+    };
+
+    private: const char* _json;
+
+    private: int32 _length;
+
+    private: std::vector<int32>& _structurals;
+
+    private: std::vector<Index::Container>& _containers;
+
+    /**
+     * Whether containers are recorded in _containers.
+     */
+    private: bool _keepsContainers;
+
+    /**
+     * Number of the next container to be opened.
+     */
+    private: int32 _container;
+
+    private: int32 _next;
+
+    private: int32 _position;
+
+    /**
+     * Stack used to validate deferred containers, kept to avoid allocating it for each of them.
+     */
+    private: std::vector< Frame< Validator > > _validatorStack;
+
+    private: StringBuilder _scratch;
+
+    private: JsonParser(const char* json, int32 length, Index& index)
+        : _json(json), _length(length), _structurals(index.structurals), _containers(index.containers)
+        , _keepsContainers(false), _container(0), _next(0), _position(0)
+    {
+    }
+
+    /**
+     * @name Stage 1
+     */
+
+    /**
+     * Bit masks describing one 64 byte block. Bit i corresponds to byte i of the block.
+     */
+    private: struct BlockMasks
+    {
+        unsigned long long quote;
+        unsigned long long backslash;
+        unsigned long long operators;
+        unsigned long long control;
+    };
+
+    /**
+     * Fills _structurals with offsets of structural characters. Returns false if the input contains
+     * an unterminated string or unescaped control characters inside a string.
+     */
+    private: bool index()
+    {
+        _structurals.reserve( ( _length / 8 ) + 16 );
+        unsigned long long prevEscaped = 0;
+        unsigned long long prevInString = 0;
+        unsigned long long controlInString = 0;
+        unsigned char tail[64];
+        for ( int32 offset = 0 ; offset < _length ; offset += 64 )
+        {
+            const unsigned char* block = (const unsigned char*)_json + offset;
+            if ( _length - offset < 64 )
+            {
+                // The last block is padded with spaces so that kernels can always read 64 bytes.
+                memset(tail, ' ', sizeof(tail));
+                memcpy(tail, block, _length - offset);
+                block = tail;
+            }
+            BlockMasks masks;
+            classify(block, masks);
+
+            unsigned long long escaped = findEscaped(masks.backslash, prevEscaped);
+            unsigned long long quote = masks.quote & ~escaped;
+            unsigned long long inString = prefixXor(quote) ^ prevInString;
+            prevInString = (unsigned long long)( (long long)inString >> 63 );
+            controlInString |= masks.control & inString;
+
+            unsigned long long structurals = ( masks.operators & ~inString ) | quote;
+            while ( 0 != structurals )
+            {
+                _structurals.push_back(offset + countTrailingZeros(structurals));
+                structurals &= structurals - 1;
+            }
+        }
+        return ( 0 == prevInString ) && ( 0 == controlInString );
+    }
+
+    /**
+     * Computes masks of quotes, backslashes, operators and control characters for 64 bytes starting at block.
+     */
+    private: static inline void classify(const unsigned char* block, BlockMasks& masks)
+    {
+#if defined(JSONPARSER_AVX2__GLYMPSE__)
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i brace = _mm256_set1_epi8('{');
+        const __m256i closingBrace = _mm256_set1_epi8('}');
+        const __m256i colon = _mm256_set1_epi8(':');
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i lowerCase = _mm256_set1_epi8(0x20);
+        const __m256i controlMax = _mm256_set1_epi8(0x1F);
+        masks.quote = masks.backslash = masks.operators = masks.control = 0;
+        for ( int32 i = 0 ; i < 2 ; ++i )
+        {
+            __m256i chunk = _mm256_loadu_si256((const __m256i*)( block + 32 * i ));
+            // '[' and ']' differ from '{' and '}' only in bit 0x20.
+            __m256i folded = _mm256_or_si256(chunk, lowerCase);
+            __m256i operators = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(folded, brace), _mm256_cmpeq_epi8(folded, closingBrace)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon), _mm256_cmpeq_epi8(chunk, comma)));
+            __m256i control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, controlMax), controlMax);
+            int32 shift = 32 * i;
+            masks.quote |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)) << shift;
+            masks.backslash |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, backslash)) << shift;
+            masks.operators |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(operators) << shift;
+            masks.control |= (unsigned long long)(unsigned int)_mm256_movemask_epi8(control) << shift;
+        }
+#elif defined(JSONPARSER_SSE2__GLYMPSE__)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i brace = _mm_set1_epi8('{');
+        const __m128i closingBrace = _mm_set1_epi8('}');
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i lowerCase = _mm_set1_epi8(0x20);
+        const __m128i controlMax = _mm_set1_epi8(0x1F);
+        masks.quote = masks.backslash = masks.operators = masks.control = 0;
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)( block + 16 * i ));
+            // '[' and ']' differ from '{' and '}' only in bit 0x20.
+            __m128i folded = _mm_or_si128(chunk, lowerCase);
+            __m128i operators = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(folded, brace), _mm_cmpeq_epi8(folded, closingBrace)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+            __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, controlMax), controlMax);
+            int32 shift = 16 * i;
+            masks.quote |= (unsigned long long)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)) << shift;
+            masks.backslash |= (unsigned long long)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)) << shift;
+            masks.operators |= (unsigned long long)(unsigned int)_mm_movemask_epi8(operators) << shift;
+            masks.control |= (unsigned long long)(unsigned int)_mm_movemask_epi8(control) << shift;
+        }
+#elif defined(JSONPARSER_NEON__GLYMPSE__)
+        uint8x16_t chunks[4];
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            chunks[i] = vld1q_u8(block + 16 * i);
+        }
+        uint8x16_t results[4];
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            results[i] = vceqq_u8(chunks[i], vdupq_n_u8('"'));
+        }
+        masks.quote = toBitMask(results);
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            results[i] = vceqq_u8(chunks[i], vdupq_n_u8('\\'));
+        }
+        masks.backslash = toBitMask(results);
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            // '[' and ']' differ from '{' and '}' only in bit 0x20.
+            uint8x16_t folded = vorrq_u8(chunks[i], vdupq_n_u8(0x20));
+            results[i] = vorrq_u8(
+                vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}'))),
+                vorrq_u8(vceqq_u8(chunks[i], vdupq_n_u8(':')), vceqq_u8(chunks[i], vdupq_n_u8(','))));
+        }
+        masks.operators = toBitMask(results);
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            results[i] = vcltq_u8(chunks[i], vdupq_n_u8(0x20));
+        }
+        masks.control = toBitMask(results);
+#else
+        masks.quote = masks.backslash = masks.operators = masks.control = 0;
+        for ( int32 i = 0 ; i < 64 ; ++i )
+        {
+            unsigned long long bit = 1ULL << i;
+            unsigned char ch = block[i];
+            switch ( ch )
+            {
+                case '"':
+                    masks.quote |= bit;
+                    break;
+                case '\\':
+                    masks.backslash |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    masks.operators |= bit;
+                    break;
+                default:
+                    if ( ch < 0x20 )
+                    {
+                        masks.control |= bit;
+                    }
+                    break;
+            }
+        }
+#endif
+    }
+
+#if defined(JSONPARSER_NEON__GLYMPSE__)
+    /**
+     * NEON has no movemask instruction. Each lane keeps one bit of its position and lanes are summed pairwise
+     * until 64 bits remain.
+     */
+    private: static inline unsigned long long toBitMask(const uint8x16_t* results)
+    {
+        static const uint8_t weights[16] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+            0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+        const uint8x16_t bits = vld1q_u8(weights);
+        uint8x16_t sum0 = vpaddq_u8(vandq_u8(results[0], bits), vandq_u8(results[1], bits));
+        uint8x16_t sum1 = vpaddq_u8(vandq_u8(results[2], bits), vandq_u8(results[3], bits));
+        sum0 = vpaddq_u8(sum0, sum1);
+        sum0 = vpaddq_u8(sum0, sum0);
+        return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+    }
+#endif
+
+    /**
+     * Returns mask of characters escaped by a backslash. A character is escaped when it is preceded
+     * by an odd-length run of backslashes, which may start in a previous block (carried in prevEscaped).
+     */
+    private: static inline unsigned long long findEscaped(unsigned long long backslash, unsigned long long& prevEscaped)
+    {
+        const unsigned long long evenBits = 0x5555555555555555ULL;
+        if ( 0 == backslash )
+        {
+            unsigned long long escaped = prevEscaped;
+            prevEscaped = 0;
+            return escaped;
+        }
+        backslash &= ~prevEscaped;
+        unsigned long long followsEscape = ( backslash << 1 ) | prevEscaped;
+        unsigned long long oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+        unsigned long long sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+        prevEscaped = ( sequencesStartingOnEvenBits < backslash ) ? 1 : 0;
+        unsigned long long invertMask = sequencesStartingOnEvenBits << 1;
+        return ( evenBits ^ invertMask ) & followsEscape;
+    }
+
+    /**
+     * Bit i of the result is the XOR of bits 0..i of mask. Applied to quote positions it yields
+     * the mask of characters inside strings (including opening quotes).
+     */
+    private: static inline unsigned long long prefixXor(unsigned long long mask)
+    {
+        mask ^= mask << 1;
+        mask ^= mask << 2;
+        mask ^= mask << 4;
+        mask ^= mask << 8;
+        mask ^= mask << 16;
+        mask ^= mask << 32;
+        return mask;
+    }
+
+    private: static inline int32 countTrailingZeros(unsigned long long mask)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return (int32)index;
+#elif defined(_MSC_VER)
+        unsigned long index;
+        if ( _BitScanForward(&index, (unsigned long)mask) )
+        {
+            return (int32)index;
+        }
+        _BitScanForward(&index, (unsigned long)( mask >> 32 ));
+        return (int32)index + 32;
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    /**
+     * @name Stage 2
+     */
+
+    /**
+     * Builds the tree by walking the structural index. Returns false on malformed input.
+     *
+     * @param depth Nesting depth of the value at the current position.
+     * @param isDocument true to require that the value is followed by the end of the text, false to stop
+     * right after the value.
+     */
+    private: template< class Builder > bool build(Builder& builder, typename Builder::Value& result, int32 depth,
+        bool isDocument)
+    {
+        std::vector< Frame< Builder > > stack;
+        return build(builder, result, depth, isDocument, stack);
+    }
+
+    /**
+     * This method is provided for callers reusing the stack.
+     * See build(Builder&, Value&, int32, bool) for more details. The stack must be empty.
+     */
+    private: template< class Builder > bool build(Builder& builder, typename Builder::Value& result, int32 depth,
+        bool isDocument, std::vector< Frame< Builder > >& stack)
+    {
+        typename Builder::Value value;
+        for ( ;; )
+        {
+            // Expecting a value.
+            skipWhitespace();
+            if ( _position >= _length )
+            {
+                return false;
+            }
+            char ch = _json[_position];
+            bool isObject = ( '{' == ch );
+            if ( !stack.empty() && ( isObject || ( '[' == ch ) ) && builder.defer((int32)stack.size() + 1) )
+            {
+                int32 container = _container;
+                if ( !skip(depth + (int32)stack.size()) )
+                {
+                    return false;
+                }
+                value = builder.createDeferred(isObject, container);
+            }
+            else if ( isObject || ( '[' == ch ) )
+            {
+                int32 container = open();
+                if ( !consumeStructural(ch) || ( depth + (int32)stack.size() >= MAX_DEPTH ) )
+                {
+                    return false;
+                }
+                Frame< Builder > frame;
+                frame.container = builder.createContainer(isObject);
+                frame.number = container;
+                frame.isObject = isObject;
+                stack.push_back(frame);
+                skipWhitespace();
+                if ( ( _position < _length ) && ( _json[_position] == ( isObject ? '}' : ']' ) ) )
+                {
+                    consumeStructural(_json[_position]);
+                    close(container);
+                    builder.finish(stack.back().container);
+                    value = stack.back().container;
+                    stack.pop_back();
+                }
+                else if ( isObject )
+                {
+                    if ( !parseKey(builder, stack.back().key) )
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                else
+                {
+                    continue;
+                }
+            }
+            else if ( '"' == ch )
+            {
+                const char* chars = NULL;
+                int32 length = 0;
+                if ( !parseString(chars, length) )
+                {
+                    return false;
+                }
+                value = builder.createString(chars, length);
+            }
+            else if ( !parseScalar(builder, value) )
+            {
+                return false;
+            }
+
+            // A value is complete. Attach it to the enclosing containers, closing them as needed.
+            for ( ;; )
+            {
+                if ( stack.empty() )
+                {
+                    if ( !isDocument )
+                    {
+                        result = value;
+                        return true;
+                    }
+                    skipWhitespace();
+                    if ( ( _position == _length ) && ( _next == (int32)_structurals.size() ) )
+                    {
+                        result = value;
+                        return true;
+                    }
+                    return false;
+                }
+                Frame< Builder >& frame = stack.back();
+                if ( frame.isObject )
+                {
+                    builder.add(frame.container, frame.key, value);
+                }
+                else
+                {
+                    builder.add(frame.container, value);
+                }
+                skipWhitespace();
+                if ( consumeStructural(',') )
+                {
+                    if ( frame.isObject && !parseKey(builder, frame.key) )
+                    {
+                        return false;
+                    }
+                    break;
+                }
+                if ( !consumeStructural(frame.isObject ? '}' : ']') )
+                {
+                    return false;
+                }
+                close(frame.number);
+                builder.finish(frame.container);
+                value = frame.container;
+                stack.pop_back();
+            }
+        }
+    }
+
+    /**
+     * Moves past the container starting at the current position. Containers validated before are skipped
+     * by looking up the matching bracket, others are validated.
+     */
+    private: bool skip(int32 depth)
+    {
+        if ( _container < (int32)_containers.size() )
+        {
+            const Index::Container& container = _containers[_container];
+            _next = container.close + 1;
+            _position = _structurals[container.close] + 1;
+            _container = container.next;
+            return true;
+        }
+        Validator validator;
+        bool ignored = false;
+        _validatorStack.clear();
+        return build(validator, ignored, depth, false, _validatorStack);
+    }
+
+    /**
+     * Returns number of the container starting at the current position, recording it if needed.
+     */
+    private: int32 open()
+    {
+        if ( _keepsContainers && ( _container == (int32)_containers.size() ) )
+        {
+            Index::Container container;
+            container.open = _next;
+            container.close = 0;
+            container.next = 0;
+            _containers.push_back(container);
+        }
+        return _container++;
+    }
+
+    /**
+     * Records the closing bracket just consumed for the container.
+     */
+    private: void close(int32 container)
+    {
+        if ( _keepsContainers )
+        {
+            _containers[container].close = _next - 1;
+            _containers[container].next = _container;
+        }
+    }
+
+    /**
+     * Consumes the next structural character if it is ch and is located at the current position.
+     */
+    private: bool consumeStructural(char ch)
+    {
+        if ( ( _next < (int32)_structurals.size() ) && ( _structurals[_next] == _position ) && ( _json[_position] == ch ) )
+        {
+            ++_next;
+            ++_position;
+            return true;
+        }
+        return false;
+    }
+
+    private: void skipWhitespace()
+    {
+        while ( _position < _length )
+        {
+            char ch = _json[_position];
+            if ( ( ' ' != ch ) && ( '\n' != ch ) && ( '\r' != ch ) && ( '\t' != ch ) )
+            {
+                break;
+            }
+            ++_position;
+        }
+    }
+
+    /**
+     * Parses object key followed by colon.
+     */
+    private: template< class Builder > bool parseKey(Builder& builder, typename Builder::Key& key)
+    {
+        skipWhitespace();
+        const char* chars = NULL;
+        int32 length = 0;
+        if ( !parseString(chars, length) )
+        {
+            return false;
+        }
+        key = builder.createKey(chars, length);
+        skipWhitespace();
+        return consumeStructural(':');
+    }
+
+    /**
+     * Parses string starting at the current position. Strings without escape sequences are returned
+     * in place, others are decoded into the scratch buffer.
+     */
+    private: bool parseString(const char*& chars, int32& length)
+    {
+        if ( !consumeStructural('"') || ( _next >= (int32)_structurals.size() ) )
+        {
+            return false;
+        }
+        int32 start = _position;
+        int32 end = _structurals[_next];
+        _position = end;
+        if ( !consumeStructural('"') )
+        {
+            return false;
+        }
+
+        chars = _json + start;
+        length = end - start;
+        if ( NULL == memchr(chars, '\\', length) )
+        {
+            return true;
+        }
+        _scratch.clear();
+        if ( !unescape(chars, length, _scratch) )
+        {
+            return false;
+        }
+        chars = _scratch.data();
+        length = _scratch.length();
+        return true;
+    }
+
+    /**
+     * Parses number or literal located between the current position and the next structural character.
+     */
+    private: template< class Builder > bool parseScalar(Builder& builder, typename Builder::Value& value)
+    {
+        int32 end = ( _next < (int32)_structurals.size() ) ? _structurals[_next] : _length;
+        const char* chars = _json + _position;
+        const char* limit = _json + end;
+        const char* parsed = NULL;
+        switch ( *chars )
+        {
+            case 't':
+                parsed = matchLiteral(chars, limit, "true", 4);
+                if ( NULL != parsed )
+                {
+                    value = builder.createBool(true);
+                }
+                break;
+            case 'f':
+                parsed = matchLiteral(chars, limit, "false", 5);
+                if ( NULL != parsed )
+                {
+                    value = builder.createBool(false);
+                }
+                break;
+            case 'n':
+                parsed = matchLiteral(chars, limit, "null", 4);
+                if ( NULL != parsed )
+                {
+                    value = builder.createNull();
+                }
+                break;
+            default:
+            {
+                int64 longValue = 0;
+                double doubleValue = 0;
+                bool isLong = false;
+                parsed = scanNumber(chars, limit, isLong, longValue, doubleValue);
+                if ( NULL != parsed )
+                {
+                    value = isLong ? builder.createLong(longValue) : builder.createDouble(doubleValue);
+                }
+                break;
+            }
+        }
+        if ( NULL == parsed )
+        {
+            return false;
+        }
+        _position = (int32)( parsed - _json );
+        return true;
+    }
+
+    /**
+     * @name Scanning Helpers
+     *
+     * Shared with JsonReader, PrimitiveCodec and PrimitiveDocument.
+     */
+
+    /**
+     * Returns hash of string characters used for key caches and tables. It is StringPool::hashBytes()
+     * with the upper half folded in, as the caches index by the low bits.
+     */
+    public: static inline unsigned int hashKey(const char* chars, int32 length)
+    {
+        unsigned int hash = StringPool::hashBytes(chars, length);
+        return hash ^ ( hash >> 16 );
+    }
+
+    /**
+     * Returns pointer past literal if chars start with it, NULL otherwise.
+     */
+    public: static const char* matchLiteral(const char* chars, const char* limit, const char* literal, int32 length)
+    {
+        return ( ( limit - chars >= length ) && ( 0 == memcmp(chars, literal, length) ) ) ? chars + length : NULL;
+    }
+
+    /**
+     * Parses JSON number. Integers without fraction and exponent that fit into int64 are stored in
+     * longValue (isLong is set), all other numbers in doubleValue.
+     *
+     * @return Pointer past the number or NULL if the syntax is invalid.
+     */
+    public: static const char* scanNumber(const char* chars, const char* limit, bool& isLong, int64& longValue,
+        double& doubleValue)
+    {
+        const char* start = chars;
+        bool negative = ( chars < limit ) && ( '-' == *chars );
+        if ( negative )
+        {
+            ++chars;
+        }
+        if ( ( chars >= limit ) || !isDigit(*chars) )
+        {
+            return NULL;
+        }
+        if ( ( '0' == *chars ) && ( chars + 1 < limit ) && isDigit(chars[1]) )
+        {
+            return NULL;
+        }
+
+        // Up to 19 significant digits are accumulated exactly; the rest only shift the exponent.
+        unsigned long long mantissa = 0;
+        int32 digits = 0;
+        int32 exponent = 0;
+        bool truncated = false;
+        for ( ; ( chars < limit ) && isDigit(*chars) ; ++chars )
+        {
+            accumulate(*chars, mantissa, digits, exponent, truncated, false);
+        }
+        bool integral = true;
+        if ( ( chars < limit ) && ( '.' == *chars ) )
+        {
+            integral = false;
+            ++chars;
+            if ( ( chars >= limit ) || !isDigit(*chars) )
+            {
+                return NULL;
+            }
+            for ( ; ( chars < limit ) && isDigit(*chars) ; ++chars )
+            {
+                accumulate(*chars, mantissa, digits, exponent, truncated, true);
+            }
+        }
+        if ( ( chars < limit ) && ( ( 'e' == *chars ) || ( 'E' == *chars ) ) )
+        {
+            integral = false;
+            ++chars;
+            bool negativeExponent = false;
+            if ( ( chars < limit ) && ( ( '+' == *chars ) || ( '-' == *chars ) ) )
+            {
+                negativeExponent = ( '-' == *chars );
+                ++chars;
+            }
+            if ( ( chars >= limit ) || !isDigit(*chars) )
+            {
+                return NULL;
+            }
+            int32 explicitExponent = 0;
+            for ( ; ( chars < limit ) && isDigit(*chars) ; ++chars )
+            {
+                if ( explicitExponent < 100000 )
+                {
+                    explicitExponent = explicitExponent * 10 + ( *chars - '0' );
+                }
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        if ( integral && !truncated && ( 0 == exponent ) &&
+            ( mantissa <= ( negative ? 9223372036854775808ULL : 9223372036854775807ULL ) ) )
+        {
+            isLong = true;
+            longValue = negative ? (int64)( 0ULL - mantissa ) : (int64)mantissa;
+            return chars;
+        }
+
+        // Exact when both the mantissa and the power of ten are exactly representable (Clinger's fast path).
+        double result;
+        if ( !truncated && ( mantissa <= 9007199254740992ULL ) && ( exponent >= -22 ) && ( exponent <= 22 ) )
+        {
+            static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+            result = ( exponent < 0 ) ? ( (double)mantissa / powers[-exponent] ) : ( (double)mantissa * powers[exponent] );
+            result = negative ? -result : result;
+        }
+        else
+        {
+            result = parseDoubleSlow(start, (int32)( chars - start ));
+        }
+        isLong = false;
+        doubleValue = result;
+        return chars;
+    }
+
+    private: static inline bool isDigit(char ch)
+    {
+        return ( ch >= '0' ) && ( ch <= '9' );
+    }
+
+    private: static inline void accumulate(char ch, unsigned long long& mantissa, int32& digits, int32& exponent,
+        bool& truncated, bool fraction)
+    {
+        if ( ( 0 == digits ) && ( '0' == ch ) )
+        {
+            // Leading zeros are not significant.
+            exponent -= fraction ? 1 : 0;
+            return;
+        }
+        if ( digits < 19 )
+        {
+            mantissa = mantissa * 10 + (unsigned long long)( ch - '0' );
+            ++digits;
+            exponent -= fraction ? 1 : 0;
+        }
+        else
+        {
+            truncated = truncated || ( '0' != ch );
+            exponent += fraction ? 0 : 1;
+        }
+    }
+
+    /**
+     * Decodes JSON escape sequences in the contents of a string literal (without quotes) and appends
+     * the result to target. Returns false if an escape sequence is malformed.
+     */
+    public: static bool unescape(const char* chars, int32 length, StringBuilder& target)
+    {
+        const char* end = chars + length;
+        while ( chars < end )
+        {
+            const char* backslash = (const char*)memchr(chars, '\\', end - chars);
+            if ( NULL == backslash )
+            {
+                target.append(chars, (int32)( end - chars ));
+                break;
+            }
+            target.append(chars, (int32)( backslash - chars ));
+            if ( backslash + 1 >= end )
+            {
+                return false;
+            }
+            chars = backslash + 2;
+            switch ( backslash[1] )
+            {
+                case '"':  target.append('"');  break;
+                case '\\': target.append('\\'); break;
+                case '/':  target.append('/');  break;
+                case 'b':  target.append('\b'); break;
+                case 'f':  target.append('\f'); break;
+                case 'n':  target.append('\n'); break;
+                case 'r':  target.append('\r'); break;
+                case 't':  target.append('\t'); break;
+                case 'u':
+                {
+                    int32 code = parseHex4(chars, end);
+                    if ( code < 0 )
+                    {
+                        return false;
+                    }
+                    chars += 4;
+                    if ( ( code >= 0xD800 ) && ( code < 0xDC00 ) && ( chars + 1 < end ) &&
+                        ( '\\' == chars[0] ) && ( 'u' == chars[1] ) )
+                    {
+                        int32 low = parseHex4(chars + 2, end);
+                        if ( ( low >= 0xDC00 ) && ( low < 0xE000 ) )
+                        {
+                            appendCodePoint(target, 0x10000 + ( ( code - 0xD800 ) << 10 ) + ( low - 0xDC00 ));
+                            chars += 6;
+                            break;
+                        }
+                    }
+                    appendCodePoint(target, code);
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    private: static int32 parseHex4(const char* chars, const char* end)
+    {
+        if ( end - chars < 4 )
+        {
+            return -1;
+        }
+        int32 code = 0;
+        for ( int32 i = 0 ; i < 4 ; ++i )
+        {
+            char ch = chars[i];
+            int32 digit = ( ( ch >= '0' ) && ( ch <= '9' ) ) ? ( ch - '0' )
+                : ( ( ch >= 'a' ) && ( ch <= 'f' ) ) ? ( ch - 'a' + 10 )
+                : ( ( ch >= 'A' ) && ( ch <= 'F' ) ) ? ( ch - 'A' + 10 ) : -1;
+            if ( digit < 0 )
+            {
+                return -1;
+            }
+            code = ( code << 4 ) | digit;
+        }
+        return code;
+    }
+
+    private: static void appendCodePoint(StringBuilder& target, int32 code)
+    {
+        if ( code < 0x10000 )
+        {
+            target.append((unichar)code);
+            return;
+        }
+        char bytes[4];
+        bytes[0] = (char)( 0xF0 | ( code >> 18 ) );
+        bytes[1] = (char)( 0x80 | ( ( code >> 12 ) & 0x3F ) );
+        bytes[2] = (char)( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+        bytes[3] = (char)( 0x80 | ( code & 0x3F ) );
+        target.append(bytes, 4);
+    }
+
+    /**
+     * Falls back to strtod(), which honors the decimal separator of the current locale.
+     */
+    private: static double parseDoubleSlow(const char* chars, int32 length)
+    {
+        char buffer[128];
+        std::vector<char> large;
+        char* copy = buffer;
+        if ( length >= (int32)sizeof(buffer) )
+        {
+            large.resize(length + 1);
+            copy = &large[0];
+        }
+        memcpy(copy, chars, length);
+        copy[length] = '\0';
+        char* point = (char*)memchr(copy, '.', length);
+        if ( NULL != point )
+        {
+            const char* separator = localeconv()->decimal_point;
+            *point = ( ( NULL != separator ) && ( '\0' != separator[0] ) ) ? separator[0] : '.';
+        }
+        return strtod(copy, NULL);
+    }
+};
+
+}
+
+#endif // !JSONPARSER_H__GLYMPSE__
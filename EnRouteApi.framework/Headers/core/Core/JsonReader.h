@@ -0,0 +1,754 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef JSONREADER_H__GLYMPSE__
+#define JSONREADER_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Receives events from JsonReader::dispatch(). Each callback returns false to stop dispatching.
+ *
+ * Handlers are invoked synchronously on the thread calling dispatch(). String views passed to key() and
+ * string() are only valid for the duration of the call.
+ */
+class JsonHandler
+{
+    public: virtual ~JsonHandler()
+    {
+    }
+
+    public: virtual bool startObject() = 0;
+
+    public: virtual bool endObject() = 0;
+
+    public: virtual bool startArray() = 0;
+
+    public: virtual bool endArray() = 0;
+
+    public: virtual bool key(const StringView& name) = 0;
+
+    public: virtual bool string(const StringView& value) = 0;
+
+    public: virtual bool longValue(int64 value) = 0;
+
+    public: virtual bool doubleValue(double value) = 0;
+
+    public: virtual bool boolValue(bool value) = 0;
+
+    public: virtual bool nullValue() = 0;
+};
+
+/**
+ * Incremental pull parser for JSON.
+ *
+ * Input is supplied in arbitrary chunks with feed() as it arrives (for example, from a network connection),
+ * and finish() marks the end of input. next() returns the next token or TOKEN_NEED_MORE when the buffered
+ * input ends in the middle of a token, in which case the consumer feeds another chunk and calls next() again.
+ * Only the unconsumed tail of the input is buffered, so memory use does not depend on the document size.
+ *
+ *     JsonReader reader;
+ *     reader.feed(chunk);
+ *     for ( int32 token = reader.next() ; token > JsonReader::TOKEN_NEED_MORE ; token = reader.next() )
+ *     {
+ *         if ( JsonReader::TOKEN_KEY == token && reader.getString().equals("tasks") ) ...
+ *     }
+ *
+ * Alternatively, dispatch() pushes tokens into a JsonHandler (SAX style); JsonPrimitiveBuilder is a handler
+ * that assembles GPrimitive tree.
+ *
+ * Values are typed the same way as in JsonParser. The reader is not thread safe.
+ */
+class JsonReader
+{
+    /**
+     * @name Tokens
+     *
+     * Values returned by next().
+     */
+
+    /**
+     * Document is malformed. The reader stays in this state.
+     */
+    public: static const int32 TOKEN_ERROR = -1;
+
+    /**
+     * Buffered input ends in the middle of a token. Feed more input or call finish().
+     */
+    public: static const int32 TOKEN_NEED_MORE = 0;
+
+    public: static const int32 TOKEN_START_OBJECT = 1;
+
+    public: static const int32 TOKEN_END_OBJECT = 2;
+
+    public: static const int32 TOKEN_START_ARRAY = 3;
+
+    public: static const int32 TOKEN_END_ARRAY = 4;
+
+    /**
+     * Object key. See getString().
+     */
+    public: static const int32 TOKEN_KEY = 5;
+
+    /**
+     * String value. See getString().
+     */
+    public: static const int32 TOKEN_STRING = 6;
+
+    /**
+     * Integer value. See getLong().
+     */
+    public: static const int32 TOKEN_LONG = 7;
+
+    /**
+     * Floating point value. See getDouble().
+     */
+    public: static const int32 TOKEN_DOUBLE = 8;
+
+    /**
+     * Boolean value. See getBool().
+     */
+    public: static const int32 TOKEN_BOOL = 9;
+
+    public: static const int32 TOKEN_NULL = 10;
+
+    /**
+     * The document has been read completely.
+     */
+    public: static const int32 TOKEN_END_DOCUMENT = 11;
+
+    private: static const int32 STATE_VALUE = 0;
+    private: static const int32 STATE_FIRST_VALUE_OR_END = 1;
+    private: static const int32 STATE_KEY = 2;
+    private: static const int32 STATE_FIRST_KEY_OR_END = 3;
+    private: static const int32 STATE_COMMA_OR_END = 4;
+    private: static const int32 STATE_DONE = 5;
+    private: static const int32 STATE_ERROR = 6;
+
+    private: std::vector<char> _buffer;
+
+    private: int32 _position;
+
+    private: bool _finished;
+
+    private: int32 _state;
+
+    /**
+     * Open containers, true for objects.
+     */
+    private: std::vector<bool> _containers;
+
+    /**
+     * Progress of scanning a string that is not complete yet, so that scanning resumes where it stopped
+     * when more input arrives.
+     */
+    private: int32 _scanStart;
+
+    private: int32 _scanOffset;
+
+    private: bool _scanEscaped;
+
+    private: StringView _string;
+
+    private: int64 _long;
+
+    private: double _double;
+
+    private: bool _bool;
+
+    private: StringBuilder _scratch;
+
+    public: JsonReader()
+        : _position(0), _finished(false), _state(STATE_VALUE), _scanStart(-1), _scanOffset(0), _scanEscaped(false),
+          _long(0), _double(0), _bool(false)
+    {
+    }
+
+    /**
+     * @name Input
+     */
+
+    /**
+     * Appends chunk of input. Invalidates views returned by getString().
+     */
+    public: void feed(const char* data, int32 length)
+    {
+        assert( !_finished );
+        if ( _position > 0 )
+        {
+            // Drop consumed input.
+            _buffer.erase(_buffer.begin(), _buffer.begin() + _position);
+            if ( _scanStart >= 0 )
+            {
+                _scanStart -= _position;
+            }
+            _position = 0;
+        }
+        _buffer.insert(_buffer.end(), data, data + length);
+    }
+
+    /**
+     * This method is provided for convenience.
+     * See feed(const char*, int32) for more details.
+     */
+    public: void feed(const StringView& chunk)
+    {
+        feed(chunk.data(), chunk.length());
+    }
+
+    /**
+     * Marks the end of input. Tokens that were waiting for more input are completed or reported as errors.
+     */
+    public: void finish()
+    {
+        _finished = true;
+    }
+
+    /**
+     * @name Pull Interface
+     */
+
+    /**
+     * Reads the next token. See TOKEN_* constants.
+     */
+    public: int32 next()
+    {
+        for ( ;; )
+        {
+            if ( STATE_ERROR == _state )
+            {
+                return TOKEN_ERROR;
+            }
+            skipWhitespace();
+            if ( _position >= (int32)_buffer.size() )
+            {
+                if ( !_finished )
+                {
+                    return TOKEN_NEED_MORE;
+                }
+                return ( STATE_DONE == _state ) ? TOKEN_END_DOCUMENT : fail();
+            }
+            char ch = _buffer[_position];
+            switch ( _state )
+            {
+                case STATE_DONE:
+                    return fail();
+                case STATE_COMMA_OR_END:
+                    if ( ',' == ch )
+                    {
+                        ++_position;
+                        _state = _containers.back() ? STATE_KEY : STATE_VALUE;
+                        continue;
+                    }
+                    return closeContainer(ch);
+                case STATE_FIRST_KEY_OR_END:
+                    if ( '}' == ch )
+                    {
+                        return closeContainer(ch);
+                    }
+                    return readKey();
+                case STATE_KEY:
+                    return readKey();
+                case STATE_FIRST_VALUE_OR_END:
+                    if ( ']' == ch )
+                    {
+                        return closeContainer(ch);
+                    }
+                    return readValue(ch);
+                default:
+                    return readValue(ch);
+            }
+        }
+    }
+
+    /**
+     * Returns the key or the string value of the last token. The view is valid until the next call
+     * to next() or feed().
+     */
+    public: const StringView& getString() const
+    {
+        return _string;
+    }
+
+    public: int64 getLong() const
+    {
+        return _long;
+    }
+
+    public: double getDouble() const
+    {
+        return _double;
+    }
+
+    public: bool getBool() const
+    {
+        return _bool;
+    }
+
+    /**
+     * Returns the number of currently open objects and arrays.
+     */
+    public: int32 getDepth() const
+    {
+        return (int32)_containers.size();
+    }
+
+    /**
+     * @name Push Interface
+     */
+
+    /**
+     * Reads tokens and forwards them to handler until more input is needed, the document ends, an error occurs
+     * or the handler asks to stop. Can be called again after feeding more input.
+     *
+     * @return The last token read: TOKEN_NEED_MORE, TOKEN_END_DOCUMENT or TOKEN_ERROR. If the handler stopped
+     * dispatching, the token it was given.
+     */
+    public: int32 dispatch(JsonHandler& handler)
+    {
+        for ( ;; )
+        {
+            int32 token = next();
+            bool proceed = true;
+            switch ( token )
+            {
+                case TOKEN_START_OBJECT:
+                    proceed = handler.startObject();
+                    break;
+                case TOKEN_END_OBJECT:
+                    proceed = handler.endObject();
+                    break;
+                case TOKEN_START_ARRAY:
+                    proceed = handler.startArray();
+                    break;
+                case TOKEN_END_ARRAY:
+                    proceed = handler.endArray();
+                    break;
+                case TOKEN_KEY:
+                    proceed = handler.key(_string);
+                    break;
+                case TOKEN_STRING:
+                    proceed = handler.string(_string);
+                    break;
+                case TOKEN_LONG:
+                    proceed = handler.longValue(_long);
+                    break;
+                case TOKEN_DOUBLE:
+                    proceed = handler.doubleValue(_double);
+                    break;
+                case TOKEN_BOOL:
+                    proceed = handler.boolValue(_bool);
+                    break;
+                case TOKEN_NULL:
+                    proceed = handler.nullValue();
+                    break;
+                default:
+                    return token;
+            }
+            if ( !proceed )
+            {
+                return token;
+            }
+        }
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: int32 fail()
+    {
+        _state = STATE_ERROR;
+        return TOKEN_ERROR;
+    }
+
+    private: void skipWhitespace()
+    {
+        int32 size = (int32)_buffer.size();
+        while ( _position < size )
+        {
+            char ch = _buffer[_position];
+            if ( ( ' ' != ch ) && ( '\n' != ch ) && ( '\r' != ch ) && ( '\t' != ch ) )
+            {
+                break;
+            }
+            ++_position;
+        }
+    }
+
+    private: int32 afterValue(int32 token)
+    {
+        _state = _containers.empty() ? STATE_DONE : STATE_COMMA_OR_END;
+        return token;
+    }
+
+    private: int32 closeContainer(char ch)
+    {
+        bool isObject = _containers.back();
+        if ( ch != ( isObject ? '}' : ']' ) )
+        {
+            return fail();
+        }
+        ++_position;
+        _containers.pop_back();
+        return afterValue(isObject ? TOKEN_END_OBJECT : TOKEN_END_ARRAY);
+    }
+
+    private: int32 readValue(char ch)
+    {
+        if ( ( '{' == ch ) || ( '[' == ch ) )
+        {
+            if ( (int32)_containers.size() >= JsonParser::MAX_DEPTH )
+            {
+                return fail();
+            }
+            ++_position;
+            _containers.push_back('{' == ch);
+            _state = ( '{' == ch ) ? STATE_FIRST_KEY_OR_END : STATE_FIRST_VALUE_OR_END;
+            return ( '{' == ch ) ? TOKEN_START_OBJECT : TOKEN_START_ARRAY;
+        }
+        if ( '"' == ch )
+        {
+            int32 token = readString();
+            return ( TOKEN_STRING == token ) ? afterValue(token) : token;
+        }
+        return readScalar();
+    }
+
+    /**
+     * Reads object key together with the following colon, so that a key token is only reported
+     * once it is certain to be followed by a value.
+     */
+    private: int32 readKey()
+    {
+        int32 start = _position;
+        int32 token = readString();
+        if ( TOKEN_STRING != token )
+        {
+            return ( TOKEN_NEED_MORE == token ) ? token : fail();
+        }
+        skipWhitespace();
+        if ( _position >= (int32)_buffer.size() )
+        {
+            if ( _finished )
+            {
+                return fail();
+            }
+            _position = start;
+            return TOKEN_NEED_MORE;
+        }
+        if ( ':' != _buffer[_position] )
+        {
+            return fail();
+        }
+        ++_position;
+        _state = STATE_VALUE;
+        return TOKEN_KEY;
+    }
+
+    /**
+     * Reads string literal starting at the current position.
+     */
+    private: int32 readString()
+    {
+        const char* data = &_buffer[0];
+        int32 size = (int32)_buffer.size();
+        if ( '"' != data[_position] )
+        {
+            return fail();
+        }
+        if ( _scanStart != _position )
+        {
+            _scanStart = _position;
+            _scanOffset = 1;
+            _scanEscaped = false;
+        }
+
+        // Find the closing quote, resuming after the part scanned before more input was needed.
+        int32 end = _position + _scanOffset;
+        for ( ; end < size ; ++end )
+        {
+            char ch = data[end];
+            if ( _scanEscaped )
+            {
+                _scanEscaped = false;
+            }
+            else if ( '\\' == ch )
+            {
+                _scanEscaped = true;
+            }
+            else if ( '"' == ch )
+            {
+                break;
+            }
+            else if ( (unsigned char)ch < 0x20 )
+            {
+                return fail();
+            }
+        }
+        if ( end >= size )
+        {
+            _scanOffset = end - _position;
+            return _finished ? fail() : TOKEN_NEED_MORE;
+        }
+
+        const char* chars = data + _position + 1;
+        int32 length = end - _position - 1;
+        _scanStart = -1;
+        _position = end + 1;
+        if ( NULL != memchr(chars, '\\', length) )
+        {
+            _scratch.clear();
+            if ( !JsonParser::unescape(chars, length, _scratch) )
+            {
+                return fail();
+            }
+            _string = _scratch.view();
+        }
+        else
+        {
+            _string = StringView(chars, length);
+        }
+        return TOKEN_STRING;
+    }
+
+    /**
+     * Reads number or literal. Scalars are delimited by whitespace or punctuation, so a scalar touching
+     * the end of buffered input is incomplete until finish() is called.
+     */
+    private: int32 readScalar()
+    {
+        const char* data = &_buffer[0];
+        int32 size = (int32)_buffer.size();
+        int32 end = _position;
+        while ( ( end < size ) && !isDelimiter(data[end]) )
+        {
+            ++end;
+        }
+        if ( ( end >= size ) && !_finished )
+        {
+            return TOKEN_NEED_MORE;
+        }
+
+        const char* chars = data + _position;
+        const char* limit = data + end;
+        const char* parsed = NULL;
+        int32 token = TOKEN_ERROR;
+        switch ( *chars )
+        {
+            case 't':
+                parsed = JsonParser::matchLiteral(chars, limit, "true", 4);
+                _bool = true;
+                token = TOKEN_BOOL;
+                break;
+            case 'f':
+                parsed = JsonParser::matchLiteral(chars, limit, "false", 5);
+                _bool = false;
+                token = TOKEN_BOOL;
+                break;
+            case 'n':
+                parsed = JsonParser::matchLiteral(chars, limit, "null", 4);
+                token = TOKEN_NULL;
+                break;
+            default:
+            {
+                bool isLong = false;
+                parsed = JsonParser::scanNumber(chars, limit, isLong, _long, _double);
+                token = isLong ? TOKEN_LONG : TOKEN_DOUBLE;
+                break;
+            }
+        }
+        if ( parsed != limit )
+        {
+            return fail();
+        }
+        _position = end;
+        return afterValue(token);
+    }
+
+    private: static inline bool isDelimiter(char ch)
+    {
+        switch ( ch )
+        {
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+            case ',':
+            case ']':
+            case '}':
+            case ':':
+            case '"':
+            case '[':
+            case '{':
+                return true;
+            default:
+                return false;
+        }
+    }
+};
+
+/**
+ * JsonHandler that assembles the events into GPrimitive tree.
+ *
+ * The builder stops dispatching as soon as one complete value has been built, so it can also materialize
+ * single elements of a large array while the rest of the document is processed as a stream:
+ *
+ *     // The reader has just returned TOKEN_START_ARRAY.
+ *     for ( ;; )
+ *     {
+ *         int32 token = reader.dispatch(builder);
+ *         if ( builder.isComplete() ) { consume(builder.getResult()); builder.reset(); }
+ *         else if ( JsonReader::TOKEN_NEED_MORE == token ) { feed more input, keep the builder as is }
+ *         else break; // TOKEN_END_ARRAY or TOKEN_ERROR
+ *     }
+ */
+class JsonPrimitiveBuilder : public JsonHandler
+{
+    private: std::vector<GPrimitive> _stack;
+
+    private: std::vector<GString> _keys;
+
+    private: GString _key;
+
+    private: GPrimitive _result;
+
+    /**
+     * Returns the root value once it is complete, NULL before that.
+     */
+    public: GPrimitive getResult() const
+    {
+        return _result;
+    }
+
+    /**
+     * Returns true if a complete value has been built.
+     */
+    public: bool isComplete() const
+    {
+        return _result != NULL;
+    }
+
+    /**
+     * Prepares the builder for the next value.
+     */
+    public: void reset()
+    {
+        _stack.clear();
+        _keys.clear();
+        _key = NULL;
+        _result = NULL;
+    }
+
+    public: virtual bool startObject()
+    {
+        return open(CC::PRIMITIVE_TYPE_OBJECT);
+    }
+
+    public: virtual bool endObject()
+    {
+        return close();
+    }
+
+    public: virtual bool startArray()
+    {
+        return open(CC::PRIMITIVE_TYPE_ARRAY);
+    }
+
+    public: virtual bool endArray()
+    {
+        return close();
+    }
+
+    public: virtual bool key(const StringView& name)
+    {
+        _key = createString(name);
+        return true;
+    }
+
+    public: virtual bool string(const StringView& value)
+    {
+        return add(CoreFactory::createPrimitive(createString(value)));
+    }
+
+    public: virtual bool longValue(int64 value)
+    {
+        return add(CoreFactory::createPrimitive(value));
+    }
+
+    public: virtual bool doubleValue(double value)
+    {
+        return add(CoreFactory::createPrimitive(value));
+    }
+
+    public: virtual bool boolValue(bool value)
+    {
+        return add(CoreFactory::createPrimitive(value));
+    }
+
+    public: virtual bool nullValue()
+    {
+        return add(CoreFactory::createPrimitive());
+    }
+
+    /**
+     * Creates string objects for keys and string values. Subclasses may override it to share instances.
+     */
+    protected: virtual GString createString(const StringView& value)
+    {
+        return value.toString();
+    }
+
+    private: bool open(int32 type)
+    {
+        _stack.push_back(CoreFactory::createPrimitive(type));
+        _keys.push_back(_key);
+        _key = NULL;
+        return true;
+    }
+
+    private: bool close()
+    {
+        if ( _stack.empty() )
+        {
+            // The end of a container the builder has not seen opened.
+            return false;
+        }
+        GPrimitive value = _stack.back();
+        _stack.pop_back();
+        _key = _keys.back();
+        _keys.pop_back();
+        return add(value);
+    }
+
+    /**
+     * Attaches value to the innermost container. Stops dispatching once the root value is complete.
+     */
+    private: bool add(const GPrimitive& value)
+    {
+        if ( _stack.empty() )
+        {
+            _result = value;
+            return false;
+        }
+        GPrimitive& container = _stack.back();
+        if ( container->isObject() )
+        {
+            container->put(_key, value);
+            _key = NULL;
+        }
+        else
+        {
+            container->put(value);
+        }
+        return true;
+    }
+};
+
+}
+
+#endif // !JSONREADER_H__GLYMPSE__
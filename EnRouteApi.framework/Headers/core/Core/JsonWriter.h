@@ -0,0 +1,537 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef JSONWRITER_H__GLYMPSE__
+#define JSONWRITER_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Destination of JsonWriter output. JsonWriter buffers its output, so sinks receive data in blocks
+ * of up to JsonWriter::BUFFER_SIZE bytes rather than token by token.
+ */
+class JsonSink
+{
+    public: virtual ~JsonSink()
+    {
+    }
+
+    /**
+     * Consumes length bytes of output.
+     */
+    public: virtual void write(const char* data, int32 length) = 0;
+
+    /**
+     * Called when the writer is flushed. Sinks holding data back should pass it on.
+     */
+    public: virtual void flush()
+    {
+    }
+};
+
+/**
+ * Sink accumulating output in memory.
+ */
+class JsonBufferSink : public JsonSink
+{
+    private: StringBuilder _buffer;
+
+    public: virtual void write(const char* data, int32 length)
+    {
+        _buffer.append(data, length);
+    }
+
+    /**
+     * Returns the output written so far without copying it.
+     */
+    public: StringView view() const
+    {
+        return _buffer.view();
+    }
+
+    /**
+     * Creates string object with the output written so far.
+     */
+    public: GString toString() const
+    {
+        return _buffer.toString();
+    }
+
+    public: void clear()
+    {
+        _buffer.clear();
+    }
+};
+
+/**
+ * Sink writing output to a stdio stream. The stream is neither owned nor closed by the sink.
+ */
+class JsonFileSink : public JsonSink
+{
+    private: FILE* _file;
+
+    private: bool _failed;
+
+    public: explicit JsonFileSink(FILE* file) : _file(file), _failed(false)
+    {
+    }
+
+    public: virtual void write(const char* data, int32 length)
+    {
+        if ( !_failed && ( fwrite(data, 1, length, _file) != (size_t)length ) )
+        {
+            _failed = true;
+        }
+    }
+
+    public: virtual void flush()
+    {
+        if ( !_failed && ( 0 != fflush(_file) ) )
+        {
+            _failed = true;
+        }
+    }
+
+    /**
+     * Returns true if any write to the stream failed.
+     */
+    public: bool hasFailed() const
+    {
+        return _failed;
+    }
+};
+
+/**
+ * Sink splitting output into chunks of fixed size, e.g. for chunked HTTP request bodies.
+ * Subclasses implement writeChunk(). The last chunk, which may be shorter, is delivered on flush().
+ */
+class JsonChunkedSink : public JsonSink
+{
+    private: int32 _chunkSize;
+
+    private: std::vector<char> _chunk;
+
+    public: explicit JsonChunkedSink(int32 chunkSize) : _chunkSize(chunkSize)
+    {
+        _chunk.reserve(chunkSize);
+    }
+
+    public: virtual void write(const char* data, int32 length)
+    {
+        while ( length > 0 )
+        {
+            int32 count = _chunkSize - (int32)_chunk.size();
+            count = ( count < length ) ? count : length;
+            _chunk.insert(_chunk.end(), data, data + count);
+            data += count;
+            length -= count;
+            if ( (int32)_chunk.size() == _chunkSize )
+            {
+                writeChunk(&_chunk[0], _chunkSize);
+                _chunk.clear();
+            }
+        }
+    }
+
+    public: virtual void flush()
+    {
+        if ( !_chunk.empty() )
+        {
+            writeChunk(&_chunk[0], (int32)_chunk.size());
+            _chunk.clear();
+        }
+    }
+
+    /**
+     * Receives one chunk of output.
+     */
+    protected: virtual void writeChunk(const char* data, int32 length) = 0;
+};
+
+/**
+ * Streaming JSON writer.
+ *
+ * Documents are emitted directly with beginObject()/key()/value()/endObject() calls and written into
+ * a JsonSink as they are produced, so no GPrimitive tree or intermediate string is needed. value(GPrimitive)
+ * writes an existing tree the same way.
+ *
+ *     JsonBufferSink sink;
+ *     JsonWriter writer(sink);
+ *     writer.beginObject();
+ *     writer.key("lat"); writer.value(47.6);
+ *     writer.endObject();
+ *     writer.flush();
+ *
+ * Output is compact (no whitespace). Strings are escaped per RFC 7159; non-ASCII characters are written
+ * as UTF-8. Doubles always include a fraction or an exponent, so they are read back as doubles, and
+ * non-finite doubles, which JSON cannot represent, are written as null.
+ *
+ * Output is buffered; call flush() (or destroy the writer) to pass it on to the sink.
+ */
+class JsonWriter
+{
+    /**
+     * Size of the internal buffer.
+     */
+    public: static const int32 BUFFER_SIZE = 1024;
+
+    private: JsonSink& _sink;
+
+    private: int32 _length;
+
+    /**
+     * Per open container: true if the next element needs a comma before it.
+     */
+    private: std::vector<bool> _needsComma;
+
+    /**
+     * True right after key(), when the value must not be preceded by a comma.
+     */
+    private: bool _afterKey;
+
+    /**
+     * True once anything has been written.
+     */
+    private: bool _started;
+
+    private: char _buffer[BUFFER_SIZE];
+
+    public: explicit JsonWriter(JsonSink& sink) : _sink(sink), _length(0), _afterKey(false), _started(false)
+    {
+    }
+
+    public: ~JsonWriter()
+    {
+        flush();
+    }
+
+    private: JsonWriter(const JsonWriter&);
+
+    private: JsonWriter& operator=(const JsonWriter&);
+
+    /**
+     * @name Structure
+     */
+
+    public: void beginObject()
+    {
+        separate();
+        put('{');
+        _needsComma.push_back(false);
+    }
+
+    public: void endObject()
+    {
+        assert( !_needsComma.empty() && !_afterKey );
+        _needsComma.pop_back();
+        put('}');
+    }
+
+    public: void beginArray()
+    {
+        separate();
+        put('[');
+        _needsComma.push_back(false);
+    }
+
+    public: void endArray()
+    {
+        assert( !_needsComma.empty() && !_afterKey );
+        _needsComma.pop_back();
+        put(']');
+    }
+
+    /**
+     * Writes object key. Must be followed by a value.
+     */
+    public: void key(const StringView& name)
+    {
+        assert( !_needsComma.empty() && !_afterKey );
+        separate();
+        writeString(name);
+        put(':');
+        _afterKey = true;
+    }
+
+    public: void key(const char* name)
+    {
+        key(StringView(name));
+    }
+
+    public: void key(const GString& name)
+    {
+        key(StringView(name));
+    }
+
+    /**
+     * @name Values
+     */
+
+    public: void value(const StringView& str)
+    {
+        separate();
+        writeString(str);
+    }
+
+    public: void value(const char* str)
+    {
+        value(StringView(str));
+    }
+
+    /**
+     * Writes string value, or null if str is NULL.
+     */
+    public: void value(const GString& str)
+    {
+        if ( str == NULL )
+        {
+            nullValue();
+            return;
+        }
+        separate();
+        writeString(StringView(str->getBytes(), str->length()));
+    }
+
+    public: void value(int32 number)
+    {
+        value((int64)number);
+    }
+
+    public: void value(int64 number)
+    {
+        separate();
+        char* target = reserve(StringBuilder::MAX_INT_LENGTH);
+        _length += StringBuilder::formatInt64(number, target);
+    }
+
+    public: void value(double number)
+    {
+        separate();
+        if ( ( number != number ) || ( number > 1.7976931348623157e308 ) || ( number < -1.7976931348623157e308 ) )
+        {
+            putRaw("null", 4);
+            return;
+        }
+        char* target = reserve(StringBuilder::MAX_DOUBLE_LENGTH + 2);
+        int32 length = StringBuilder::formatDouble(number, target);
+        if ( ( NULL == memchr(target, '.', length) ) && ( NULL == memchr(target, 'e', length) ) )
+        {
+            // Integral doubles keep a fraction, so that they are not read back as longs.
+            target[length++] = '.';
+            target[length++] = '0';
+        }
+        _length += length;
+    }
+
+    public: void value(bool flag)
+    {
+        separate();
+        if ( flag )
+        {
+            putRaw("true", 4);
+        }
+        else
+        {
+            putRaw("false", 5);
+        }
+    }
+
+    public: void nullValue()
+    {
+        separate();
+        putRaw("null", 4);
+    }
+
+    /**
+     * Writes primitive and everything it contains. NULL is written as null.
+     */
+    public: void value(const GPrimitive& primitive)
+    {
+        if ( primitive == NULL )
+        {
+            nullValue();
+            return;
+        }
+        switch ( primitive->type() )
+        {
+            case CC::PRIMITIVE_TYPE_OBJECT:
+            {
+                beginObject();
+                GEnumeration<GString>::ptr keys = primitive->getKeys();
+                while ( ( keys != NULL ) && keys->hasMoreElements() )
+                {
+                    GString name = keys->nextElement();
+                    key(name);
+                    value(primitive->get(name));
+                }
+                endObject();
+                break;
+            }
+            case CC::PRIMITIVE_TYPE_ARRAY:
+            {
+                beginArray();
+                int32 size = primitive->size();
+                for ( int32 i = 0 ; i < size ; ++i )
+                {
+                    value(primitive->get(i));
+                }
+                endArray();
+                break;
+            }
+            case CC::PRIMITIVE_TYPE_DOUBLE:
+                value(primitive->getDouble());
+                break;
+            case CC::PRIMITIVE_TYPE_LONG:
+                value(primitive->getLong());
+                break;
+            case CC::PRIMITIVE_TYPE_BOOLEAN:
+                value(primitive->getBool());
+                break;
+            case CC::PRIMITIVE_TYPE_STRING:
+                value(primitive->getString());
+                break;
+            default:
+                nullValue();
+                break;
+        }
+    }
+
+    /**
+     * Returns true when a complete top level value has been written.
+     */
+    public: bool isComplete() const
+    {
+        return _started && _needsComma.empty() && !_afterKey;
+    }
+
+    /**
+     * Passes buffered output on to the sink and flushes the sink.
+     */
+    public: void flush()
+    {
+        drain();
+        _sink.flush();
+    }
+
+    /**
+     * @name Internals
+     */
+
+    /**
+     * Emits comma between elements of the current container.
+     */
+    private: void separate()
+    {
+        _started = true;
+        if ( _afterKey )
+        {
+            _afterKey = false;
+            return;
+        }
+        if ( !_needsComma.empty() )
+        {
+            if ( _needsComma.back() )
+            {
+                put(',');
+            }
+            else
+            {
+                _needsComma.back() = true;
+            }
+        }
+    }
+
+    private: void writeString(const StringView& str)
+    {
+        put('"');
+        const char* chars = str.data();
+        const char* end = chars + str.length();
+        const char* run = chars;
+        for ( ; chars < end ; ++chars )
+        {
+            unsigned char ch = (unsigned char)*chars;
+            if ( ( ch >= 0x20 ) && ( '"' != ch ) && ( '\\' != ch ) )
+            {
+                continue;
+            }
+            putRaw(run, (int32)( chars - run ));
+            run = chars + 1;
+            char* target = reserve(6);
+            target[0] = '\\';
+            switch ( ch )
+            {
+                case '"':  target[1] = '"';  _length += 2; break;
+                case '\\': target[1] = '\\'; _length += 2; break;
+                case '\n': target[1] = 'n';  _length += 2; break;
+                case '\r': target[1] = 'r';  _length += 2; break;
+                case '\t': target[1] = 't';  _length += 2; break;
+                case '\b': target[1] = 'b';  _length += 2; break;
+                case '\f': target[1] = 'f';  _length += 2; break;
+                default:
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    target[1] = 'u';
+                    target[2] = '0';
+                    target[3] = '0';
+                    target[4] = hex[ch >> 4];
+                    target[5] = hex[ch & 0xF];
+                    _length += 6;
+                    break;
+                }
+            }
+        }
+        putRaw(run, (int32)( end - run ));
+        put('"');
+    }
+
+    private: void put(char ch)
+    {
+        *reserve(1) = ch;
+        ++_length;
+    }
+
+    private: void putRaw(const char* data, int32 length)
+    {
+        if ( length > BUFFER_SIZE - _length )
+        {
+            drain();
+            if ( length > BUFFER_SIZE )
+            {
+                // Large blocks go to the sink directly.
+                _sink.write(data, length);
+                return;
+            }
+        }
+        memcpy(_buffer + _length, data, length);
+        _length += length;
+    }
+
+    /**
+     * Returns pointer to at least count free bytes in the buffer. Callers advance _length themselves.
+     */
+    private: char* reserve(int32 count)
+    {
+        if ( count > BUFFER_SIZE - _length )
+        {
+            drain();
+        }
+        return _buffer + _length;
+    }
+
+    private: void drain()
+    {
+        if ( _length > 0 )
+        {
+            _sink.write(_buffer, _length);
+            _length = 0;
+        }
+    }
+};
+
+}
+
+#endif // !JSONWRITER_H__GLYMPSE__
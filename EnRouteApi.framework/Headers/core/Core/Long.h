@@ -14,17 +14,92 @@ namespace Glympse
  * The wrapper for the primitive type long.
  *
  * This class also serves the purpose of being an example of extending and implementing the ICommon interface.
+ *
+ * Instances are allocated from ObjectPool<Long>, as they are created in large numbers (ids, context keys).
+ * Small values (CACHE_LOW..CACHE_HIGH) returned by valueOf() and values passed to intern() are immortal:
+ * they are preallocated once, never freed and skip reference counting altogether.
  */
-/*S*public**/ class Long : public Common< ILong >
+/*S*public**/ class Long : public Common< ILong >/*C*/, public Pooled< Long >/**/
 {
     public: static const int64 MAX_VALUE/*S* = Int64.MaxValue**/;
     
     private: int64 _value;
     
+    /*C*/
+    /**
+     * Range of values preallocated by valueOf().
+     */
+    public: static const int32 CACHE_LOW = -128;
+    public: static const int32 CACHE_HIGH = 1023;
+    
+    /**
+     * Maximum number of values that can be interned with intern().
+     */
+    public: static const int32 INTERN_CAPACITY = 512;
+    
+    private: static const int32 CACHE_SIZE = CACHE_HIGH - CACHE_LOW + 1;
+    private: static const int32 IMMORTAL_CAPACITY = CACHE_SIZE + INTERN_CAPACITY;
+    private: static const int32 INTERN_TABLE_SIZE = 2 * INTERN_CAPACITY;
+    /**/
+    
+    /**
+     * Returns Long object representing the specified value. Values in CACHE_LOW..CACHE_HIGH range
+     * are served from the immortal cache without allocating.
+     */
     public: static inline GLong valueOf(int64 value)
     {
+        /*C*/
+        if ( ( value >= CACHE_LOW ) && ( value <= CACHE_HIGH ) )
+        {
+            return GLong(getCache() + ( value - CACHE_LOW ));
+        }
+        /**/
         return new Long(value);
     }
+    
+    /*C*/
+    /**
+     * Returns immortal Long object for the specified value. Meant for frequently used large values
+     * (e.g. partner or organization ids), which are outside of valueOf() cache range.
+     *
+     * Interned instances are never freed. Once INTERN_CAPACITY values have been interned,
+     * the method falls back to valueOf().
+     */
+    public: static GLong intern(int64 value)
+    {
+        if ( ( value >= CACHE_LOW ) && ( value <= CACHE_HIGH ) )
+        {
+            return valueOf(value);
+        }
+        
+        Long** table = getInternTable();
+        int32 mask = INTERN_TABLE_SIZE - 1;
+        for ( int32 probe = 0, index = Common<ILong>::mixHashCode(value) & mask ; probe < INTERN_TABLE_SIZE ; ++probe, index = ( index + 1 ) & mask )
+        {
+            Long* entry = Concurrent::load(table + index);
+            if ( NULL == entry )
+            {
+                // Slots lost to insertion races are not reused.
+                int32 slot = claimSlot();
+                if ( slot < 0 )
+                {
+                    break;
+                }
+                entry = ::new ( getImmortalStorage() + slot * sizeof(Long) ) Long(value);
+                if ( Concurrent::compareAndSwap(table + index, (Long*)NULL, entry) )
+                {
+                    return GLong(entry);
+                }
+                entry = Concurrent::load(table + index);
+            }
+            if ( entry->_value == value )
+            {
+                return GLong(entry);
+            }
+        }
+        return valueOf(value);
+    }
+    /**/
 
     public: Long()
         /*C*/: _value(0)/**/
@@ -43,6 +118,34 @@ namespace Glympse
         return _value;
     }
     
+    /*C*/
+    /**
+     * @name Reference counting
+     *
+     * Immortal instances ignore reference counting.
+     */
+    
+    public: virtual int32 retain()
+    {
+        return isImmortal() ? 1 : Common< ILong >::retain();
+    }
+    
+    public: virtual int32 release()
+    {
+        return isImmortal() ? 1 : Common< ILong >::release();
+    }
+    
+    public: virtual int32 hold()
+    {
+        return isImmortal() ? 1 : Common< ILong >::hold();
+    }
+    
+    public: virtual int32 unhold()
+    {
+        return isImmortal() ? 1 : Common< ILong >::unhold();
+    }
+    /**/
+    
     /**
      * Returns a hash code for this Long. The result is the exclusive OR of the two halves of the primitive long value 
      * held by this Long object. That is, the hashcode is the value of the expression:
@@ -62,6 +165,71 @@ namespace Glympse
         O<Long> l = (O<Long>)o;
         return ( ( l != NULL ) && ( l->_value == _value ) );
     }
+    
+    /*C*/
+    /**
+     * @name Immortal storage
+     *
+     * Raw storage holding value cache followed by interned values. Objects placed there
+     * are never destroyed, so they stay valid even during static destruction.
+     */
+    
+    private: static inline char* getImmortalStorage()
+    {
+        alignas(Long) static char storage[IMMORTAL_CAPACITY * sizeof(Long)];
+        return storage;
+    }
+    
+    private: inline bool isImmortal()
+    {
+        return ( (size_t)this - (size_t)getImmortalStorage() ) < ( IMMORTAL_CAPACITY * sizeof(Long) );
+    }
+    
+    private: static Long* createCache()
+    {
+        Long* cache = (Long*)getImmortalStorage();
+        for ( int32 i = 0 ; i < CACHE_SIZE ; ++i )
+        {
+            ::new ( cache + i ) Long(CACHE_LOW + i);
+        }
+        return cache;
+    }
+    
+    private: static inline Long* getCache()
+    {
+        static Long* cache = createCache();
+        return cache;
+    }
+    
+    private: static inline Long** getInternTable()
+    {
+        static Long* table[INTERN_TABLE_SIZE];
+        return table;
+    }
+    
+    private: static inline int32* getInternCount()
+    {
+        static int32 count;
+        return &count;
+    }
+    
+    /**
+     * Reserves a slot in immortal storage for an interned value. Returns -1 once storage is full.
+     * The counter never goes past INTERN_CAPACITY, no matter how many times this is called.
+     */
+    private: static int32 claimSlot()
+    {
+        int32* count = getInternCount();
+        for ( int32 claimed = Concurrent::load(count) ; claimed < INTERN_CAPACITY ; claimed = Concurrent::load(count) )
+        {
+            if ( Concurrent::compareAndSwap(count, claimed, claimed + 1) )
+            {
+                return CACHE_SIZE + claimed;
+            }
+        }
+        return -1;
+    }
+    /**/
 };
     
 }
@@ -12,7 +12,26 @@ namespace Glympse
 
 // Provides explicit scope for Common class used in friend declaration below. Needed for
 // blackberry compiler.
-template< class T > class Common;
+template< class T, class RefPolicy > class Common;
+
+/**
+ * Converts pointers between types of smart pointers. Implicit conversions (upcasts to an interface
+ * or ICommon) are resolved at compile time and cost nothing. Everything else falls back to dynamic_cast.
+ */
+template< class T, class T2, bool Implicit = std::is_convertible< T2*, T* >::value > struct ObjectCast
+{
+    static inline T* cast(T2* object)
+    {
+        return dynamic_cast<T*>(object);
+    }
+};
+template< class T, class T2 > struct ObjectCast< T, T2, true >
+{
+    static inline T* cast(T2* object)
+    {
+        return object;
+    }
+};
 
 /**
  * Smart pointer designed to maintain lifetime of objects with internal reference counting 
@@ -24,8 +43,13 @@ template< class T > class Common;
  * - Reference counter is incremented, when O<T> is initialized with another object of O<T> type
  *   (both constructed and assigned to).
  * - Reference counter is incremented, when O<T> is initialized with another object of O<Y> type,
- *   if Y can be casted dynamically to T (using dynamic_cast).
+ *   if Y can be casted to T (using static_cast, if Y* converts to T* implicitly, or dynamic_cast otherwise).
  * - Reference counter is decremented unconditionally, when instance of O<T> is destroyed.
+ * - Reference counter is not touched, when O<T> is moved from another O<T> or O<Y> instance
+ *   (both constructed and assigned to). The source is left empty.
+ *
+ * Moves let temporaries and return values hand their reference over without the atomic
+ * increment/decrement pair a copy costs.
  */
 template< class T > class O
 {
@@ -39,7 +63,7 @@ template< class T > class O
      * need access to _object between types of O. We can allow this by friending our main type.
      */
     template< class U > friend class O;
-    template< class V > friend class Common;
+    template< class V, class P > friend class Common;
     
     /**
      * @name Constructors
@@ -59,12 +83,26 @@ template< class T > class O
     public: O(const O<T>& rO)
         : _object(rO._object)
     {
-        retain();
+        retainObject();
     }
     public: template< class T2 > O(const O<T2>& rO)
-        : _object(dynamic_cast<T*>(rO._object))
+        : _object(ObjectCast<T, T2>::cast(rO._object))
+    {
+        retainObject();
+    }
+    public: O(O<T>&& rO)
+        : _object(rO._object)
     {
-        retain();
+        rO._object = NULL;
+    }
+    public: template< class T2 > O(O<T2>&& rO)
+        : _object(ObjectCast<T, T2>::cast(rO._object))
+    {
+        // Reference is only transferred, if the cast succeeded. Otherwise the source keeps it.
+        if ( _object )
+        {
+            rO._object = NULL;
+        }
     }
     
     /**
@@ -73,7 +111,7 @@ template< class T > class O
     
     public: O<T>& operator=(T* address)
     {
-        release();
+        releaseObject();
         _object = address;
         return *this;
     }    
@@ -81,17 +119,42 @@ template< class T > class O
     {
         if ( this != &rO )
         {
-            release();
+            releaseObject();
             _object = rO._object;
-            retain();
+            retainObject();
         }
         return *this;
     }
     public: template< class T2 > O<T>& operator=(const O<T2>& rO)
     {
-        release();
-        _object = dynamic_cast<T*>(rO._object);
-        retain();
+        T* object = ObjectCast<T, T2>::cast(rO._object);
+        if ( object )
+        {
+            object->retain();
+        }
+        releaseObject();
+        _object = object;
+        return *this;
+    }
+    public: O<T>& operator=(O<T>&& rO)
+    {
+        if ( this != &rO )
+        {
+            releaseObject();
+            _object = rO._object;
+            rO._object = NULL;
+        }
+        return *this;
+    }
+    public: template< class T2 > O<T>& operator=(O<T2>&& rO)
+    {
+        T* object = ObjectCast<T, T2>::cast(rO._object);
+        if ( object )
+        {
+            rO._object = NULL;
+        }
+        releaseObject();
+        _object = object;
         return *this;
     }
     
@@ -101,10 +164,63 @@ template< class T > class O
     
     /**
      * Regardless of how we obtained the object we are pointing to, we release it when we destuct.
+     * The destructor stays virtual: the prebuilt library is compiled against this layout.
      */
     public: virtual ~O()
     {
-        release();
+        releaseObject();
+    }
+
+    /**
+     * @name Ownership Management
+     */
+
+    /**
+     * Drops the reference (if any) and leaves this instance empty.
+     */
+    public: inline void reset()
+    {
+        releaseObject();
+    }
+
+    /**
+     * Takes ownership of the reference already owned by the caller. Reference counter is not incremented.
+     * This is equivalent to assigning raw pointer, but makes the intent explicit at call site.
+     */
+    public: inline void adopt(T* address)
+    {
+        releaseObject();
+        _object = address;
+    }
+
+    /**
+     * Relinquishes ownership of the referenced object without decrementing its reference counter.
+     * The caller becomes responsible for calling ICommon::release() on the returned pointer
+     * (or handing it to adopt()).
+     */
+    public: inline T* release()
+    {
+        T* object = _object;
+        _object = NULL;
+        return object;
+    }
+
+    /**
+     * Returns raw pointer without affecting reference counter.
+     */
+    public: inline T* get() const
+    {
+        return _object;
+    }
+
+    /**
+     * Exchanges referenced objects of two smart pointers. Reference counters are not touched.
+     */
+    public: inline void swap(O<T>& rO)
+    {
+        T* object = _object;
+        _object = rO._object;
+        rO._object = object;
     }
 
     /**
@@ -181,7 +297,7 @@ template< class T > class O
     /**
      * Internal helper function to safely add a reference.
      */
-    private: inline void retain()
+    private: inline void retainObject()
     {
         if ( _object )
         {
@@ -192,7 +308,7 @@ template< class T > class O
     /**
      * Internal helper function to safely release a reference.
      */
-    private: inline void release()
+    private: inline void releaseObject()
     {
         if ( _object )
         {
@@ -220,6 +336,32 @@ template< class T > inline bool operator!=(void* lhs, const O<T>& rhs)
     return ( lhs != rhs.operator->() );
 }
 
+/**
+ * Explicit downcast (or cross-cast) of a smart pointer. Returns empty pointer, if the object
+ * is not of type T. Always uses dynamic_cast, so prefer implicit conversions for upcasts.
+ * <pre>
+ * GTicket ticket = o_dynamic_cast<ITicket>(obj);
+ * </pre>
+ */
+template< class T, class T2 > inline O<T> o_dynamic_cast(const O<T2>& rO)
+{
+    T* object = dynamic_cast<T*>(rO.get());
+    if ( object )
+    {
+        object->retain();
+    }
+    return O<T>(object);
+}
+
+/**
+ * Standalone swap() for ADL, so that standard algorithms exchange smart pointers
+ * without touching reference counters.
+ */
+template< class T > inline void swap(O<T>& lhs, O<T>& rhs)
+{
+    lhs.swap(rhs);
+}
+
 /**
  * The Object class provides some helpers for dealing with O<T> objects. 
  */
@@ -248,9 +390,8 @@ class Object
      */
     public: template<typename T> static inline O<T> fromThis(T* t)
     {
-        const O<T>& o(t);
-        o->retain();
-        return o;
+        t->retain();
+        return O<T>(t);
     }
 };
         
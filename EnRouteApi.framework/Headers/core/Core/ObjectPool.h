@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef OBJECTPOOL_H__GLYMPSE__
+#define OBJECTPOOL_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Occupancy statistics of ObjectPool.
+ */
+struct PoolStats
+{
+    /**
+     * Number of slabs allocated from the heap so far. Slabs are never returned to the heap.
+     */
+    int32 slabs;
+
+    /**
+     * Total number of blocks available in all slabs.
+     */
+    int32 capacity;
+
+    /**
+     * Number of blocks currently occupied by live objects.
+     */
+    int32 live;
+
+    /**
+     * Highest number of simultaneously live objects observed.
+     */
+    int32 peak;
+};
+
+/**
+ * Slab allocator for fixed size blocks fitting objects of type T.
+ *
+ * Blocks are carved out of slabs of SLAB_SIZE blocks each. Freed blocks are put back on
+ * a free list owned by the calling thread (up to CACHE_SIZE blocks), excess is returned
+ * to the free list shared by all threads. Thread caches are flushed to the shared list
+ * when thread terminates.
+ *
+ * The pool is not used directly. Classes opt in by deriving from Pooled<T>.
+ */
+template< class T > class ObjectPool
+{
+    private: ObjectPool();
+
+    /**
+     * Number of blocks allocated from the heap at once.
+     */
+    public: static const int32 SLAB_SIZE = 64;
+
+    /**
+     * Number of free blocks each thread keeps for itself.
+     */
+    public: static const int32 CACHE_SIZE = 32;
+
+    private: struct Block
+    {
+        Block* next;
+    };
+
+    private: static const size_t ALIGNMENT = ( alignof(T) > alignof(Block) ) ? alignof(T) : alignof(Block);
+
+    private: static const size_t BLOCK_SIZE = ( ( ( ( sizeof(T) > sizeof(Block) ) ? sizeof(T) : sizeof(Block) )
+        + ALIGNMENT - 1 ) / ALIGNMENT ) * ALIGNMENT;
+
+    /**
+     * The mutex is allocated once and never destroyed, so that threads exiting after static
+     * destructors have run can still flush their caches.
+     */
+    private: struct Shared
+    {
+        std::mutex* lock;
+        Block* free;
+        int32 slabs;
+        int32 live;
+        int32 peak;
+    };
+
+    /**
+     * Trivially destructible, so that it stays accessible until the very end of thread lifetime.
+     */
+    private: struct Cache
+    {
+        Block* free;
+        int32 count;
+        bool detached;
+    };
+
+    /**
+     * Flushes thread cache to the shared list on thread exit.
+     */
+    private: struct CacheGuard
+    {
+        Cache* cache;
+
+        ~CacheGuard()
+        {
+            cache->detached = true;
+            ObjectPool<T>::flush(*cache, cache->count);
+        }
+    };
+
+    /**
+     * @name Allocation
+     */
+
+    public: static void* allocate()
+    {
+        Cache& cache = getCache();
+        if ( NULL == cache.free )
+        {
+            refill(cache);
+        }
+        Block* block = cache.free;
+        cache.free = block->next;
+        --cache.count;
+
+        Shared& shared = getShared();
+        int32 live = Concurrent::addRelaxed(&shared.live, 1);
+        for ( int32 peak = Concurrent::load(&shared.peak) ; live > peak ; peak = Concurrent::load(&shared.peak) )
+        {
+            if ( Concurrent::compareAndSwap(&shared.peak, peak, live) )
+            {
+                break;
+            }
+        }
+        return block;
+    }
+
+    public: static void deallocate(void* ptr)
+    {
+        Concurrent::addRelaxed(&getShared().live, -1);
+
+        Cache& cache = getCache();
+        Block* block = (Block*)ptr;
+        block->next = cache.free;
+        cache.free = block;
+        ++cache.count;
+        if ( cache.detached )
+        {
+            flush(cache, cache.count);
+        }
+        else if ( cache.count > 2 * CACHE_SIZE )
+        {
+            flush(cache, CACHE_SIZE);
+        }
+    }
+
+    /**
+     * @name Statistics
+     */
+
+    public: static PoolStats getStats()
+    {
+        Shared& shared = getShared();
+        PoolStats stats;
+        stats.slabs = Concurrent::load(&shared.slabs);
+        stats.capacity = stats.slabs * SLAB_SIZE;
+        stats.live = Concurrent::load(&shared.live);
+        stats.peak = Concurrent::load(&shared.peak);
+        return stats;
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static Shared& getShared()
+    {
+        static Shared shared = { new std::mutex(), NULL, 0, 0, 0 };
+        return shared;
+    }
+
+    private: static Cache& getCache()
+    {
+        static thread_local Cache cache = { NULL, 0, false };
+        static thread_local CacheGuard guard = { &cache };
+        (void)guard;
+        return cache;
+    }
+
+    /**
+     * Blocking mutex rather than a spin lock: with QoS scheduling a spinning high priority
+     * thread can starve a preempted low priority holder indefinitely.
+     */
+    private: static void lock(Shared& shared)
+    {
+        shared.lock->lock();
+    }
+
+    private: static void unlock(Shared& shared)
+    {
+        shared.lock->unlock();
+    }
+
+    /**
+     * Moves up to CACHE_SIZE blocks from the shared list to thread cache.
+     * Allocates new slab, if shared list is empty.
+     */
+    private: static void refill(Cache& cache)
+    {
+        Shared& shared = getShared();
+        lock(shared);
+        for ( int32 i = 0 ; ( i < CACHE_SIZE ) && ( NULL != shared.free ) ; ++i )
+        {
+            Block* block = shared.free;
+            shared.free = block->next;
+            block->next = cache.free;
+            cache.free = block;
+            ++cache.count;
+        }
+        unlock(shared);
+        if ( NULL != cache.free )
+        {
+            return;
+        }
+
+        char* slab = (char*)::operator new(BLOCK_SIZE * SLAB_SIZE);
+        for ( int32 i = SLAB_SIZE - 1 ; i >= 0 ; --i )
+        {
+            Block* block = (Block*)( slab + i * BLOCK_SIZE );
+            block->next = cache.free;
+            cache.free = block;
+        }
+        cache.count += SLAB_SIZE;
+        Concurrent::addRelaxed(&shared.slabs, 1);
+    }
+
+    /**
+     * Moves count blocks from thread cache to the shared list.
+     */
+    private: static void flush(Cache& cache, int32 count)
+    {
+        if ( 0 == count )
+        {
+            return;
+        }
+        Block* first = cache.free;
+        Block* last = first;
+        for ( int32 i = 1 ; i < count ; ++i )
+        {
+            last = last->next;
+        }
+        cache.free = last->next;
+        cache.count -= count;
+
+        Shared& shared = getShared();
+        lock(shared);
+        last->next = shared.free;
+        shared.free = first;
+        unlock(shared);
+    }
+};
+
+/**
+ * Opts class T in to pooled allocation. Objects of exactly type T are allocated from ObjectPool<T>,
+ * derived classes of different size fall back to the general heap.
+ * <pre>
+ * class Foo : public Common< IFoo >, public Pooled< Foo >
+ * </pre>
+ */
+template< class T > class Pooled
+{
+    public: static inline void* operator new(size_t size)
+    {
+        return ( sizeof(T) == size ) ? ObjectPool<T>::allocate() : ::operator new(size);
+    }
+
+    public: static inline void operator delete(void* ptr, size_t size)
+    {
+        if ( sizeof(T) == size )
+        {
+            ObjectPool<T>::deallocate(ptr);
+        }
+        else
+        {
+            ::operator delete(ptr);
+        }
+    }
+
+    /**
+     * Returns occupancy statistics of the pool backing T.
+     */
+    public: static inline PoolStats getPoolStats()
+    {
+        return ObjectPool<T>::getStats();
+    }
+};
+
+}
+
+#endif // !OBJECTPOOL_H__GLYMPSE__
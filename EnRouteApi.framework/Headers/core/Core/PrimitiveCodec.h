@@ -0,0 +1,587 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef PRIMITIVECODEC_H__GLYMPSE__
+#define PRIMITIVECODEC_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Binary serialization of the IPrimitive model based on CBOR (RFC 8949).
+ *
+ * All primitive types map to native CBOR types: objects to maps, arrays to arrays, longs to
+ * (negative) integers, doubles to single or double precision floats (whichever is exact), booleans and null
+ * to simple values. Integer and length heads take 1 byte for values below 24 and grow with the value.
+ *
+ * Repeated strings (object keys in particular) are written once and then referenced by index, using
+ * the stringref extension (tags 256 and 25, see http://cbor.schmorp.de/stringref). Documents start with
+ * the self-described CBOR tag (0xD9D9F7), which can never start JSON text, so isBinary() tells the formats
+ * apart reliably.
+ *
+ * Decoding into a JsonHandler does not copy strings: handlers receive views into the input buffer, and
+ * all references to the same string yield the same view. Decoding into GPrimitive creates each distinct
+ * string object once.
+ */
+class PrimitiveCodec
+{
+    private: PrimitiveCodec();
+
+    /**
+     * @name Encoding
+     */
+
+    /**
+     * Appends binary encoding of data to output.
+     */
+    public: static void encode(const GPrimitive& data, StringBuilder& output)
+    {
+        Encoder encoder(output);
+        // Self-described CBOR marker followed by the root stringref namespace.
+        output.append("\xD9\xD9\xF7\xD9\x01\x00", 6);
+        encoder.encode(data);
+    }
+
+    /**
+     * @name Decoding
+     */
+
+    /**
+     * Returns true if data starts with the marker written by encode().
+     */
+    public: static bool isBinary(const char* data, int32 length)
+    {
+        return ( length >= 3 ) && ( 0 == memcmp(data, "\xD9\xD9\xF7", 3) );
+    }
+
+    /**
+     * Decodes binary data into GPrimitive tree. Returns NULL if data is malformed.
+     */
+    public: static GPrimitive decode(const char* data, int32 length)
+    {
+        SharedStringBuilder builder;
+        return decode(data, length, builder) ? builder.getResult() : GPrimitive();
+    }
+
+    /**
+     * Decodes binary data into events of handler. String views passed to the handler point into data.
+     *
+     * @return true if the whole input was decoded, false if it is malformed or the handler stopped early.
+     */
+    public: static bool decode(const char* data, int32 length, JsonHandler& handler)
+    {
+        Decoder decoder((const unsigned char*)data, length, handler);
+        return decoder.decodeDocument();
+    }
+
+    /**
+     * Decodes data in either binary or JSON format, detecting the format from the contents.
+     */
+    public: static GPrimitive decodeAny(const char* data, int32 length)
+    {
+        return isBinary(data, length) ? decode(data, length) : JsonParser::parse(data, length);
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static const int32 MAJOR_UNSIGNED = 0;
+    private: static const int32 MAJOR_NEGATIVE = 1;
+    private: static const int32 MAJOR_BYTES = 2;
+    private: static const int32 MAJOR_TEXT = 3;
+    private: static const int32 MAJOR_ARRAY = 4;
+    private: static const int32 MAJOR_MAP = 5;
+    private: static const int32 MAJOR_TAG = 6;
+    private: static const int32 MAJOR_SIMPLE = 7;
+
+    private: static const int32 TAG_STRINGREF = 25;
+    private: static const int32 TAG_STRINGREF_NAMESPACE = 256;
+
+    /**
+     * The stringref rule: a string enters the table only if referencing it is shorter than repeating it.
+     * Encoder and decoder apply the same rule, so indexes need not be transmitted.
+     */
+    private: static inline bool isReferenceable(int32 length, int32 count)
+    {
+        return length >= ( ( count < 24 ) ? 3 : ( count < 256 ) ? 4 : ( count < 65536 ) ? 5 : 7 );
+    }
+
+    private: class Encoder
+    {
+        private: struct Entry
+        {
+            const char* data;
+            int32 length;
+            int32 index;
+        };
+
+        private: StringBuilder& _output;
+
+        /**
+         * Open addressing table of referenceable strings. Points into the strings held by _strings.
+         */
+        private: std::vector<Entry> _table;
+
+        private: std::vector<GString> _strings;
+
+        private: int32 _count;
+
+        public: Encoder(StringBuilder& output) : _output(output), _count(0)
+        {
+            Entry empty = { NULL, 0, 0 };
+            _table.assign(64, empty);
+        }
+
+        public: void encode(const GPrimitive& value)
+        {
+            if ( value == NULL )
+            {
+                _output.append((char)0xF6);
+                return;
+            }
+            switch ( value->type() )
+            {
+                case CC::PRIMITIVE_TYPE_OBJECT:
+                {
+                    writeHead(MAJOR_MAP, (unsigned long long)value->size());
+                    GEnumeration<GString>::ptr keys = value->getKeys();
+                    while ( ( keys != NULL ) && keys->hasMoreElements() )
+                    {
+                        GString key = keys->nextElement();
+                        writeString(key);
+                        encode(value->get(key));
+                    }
+                    break;
+                }
+                case CC::PRIMITIVE_TYPE_ARRAY:
+                {
+                    int32 size = value->size();
+                    writeHead(MAJOR_ARRAY, (unsigned long long)size);
+                    for ( int32 i = 0 ; i < size ; ++i )
+                    {
+                        encode(value->get(i));
+                    }
+                    break;
+                }
+                case CC::PRIMITIVE_TYPE_LONG:
+                {
+                    int64 number = value->getLong();
+                    if ( number >= 0 )
+                    {
+                        writeHead(MAJOR_UNSIGNED, (unsigned long long)number);
+                    }
+                    else
+                    {
+                        // -1 - n, computed without overflow for INT64_MIN.
+                        writeHead(MAJOR_NEGATIVE, ~(unsigned long long)number);
+                    }
+                    break;
+                }
+                case CC::PRIMITIVE_TYPE_DOUBLE:
+                    writeDouble(value->getDouble());
+                    break;
+                case CC::PRIMITIVE_TYPE_BOOLEAN:
+                    _output.append((char)( value->getBool() ? 0xF5 : 0xF4 ));
+                    break;
+                case CC::PRIMITIVE_TYPE_STRING:
+                    writeString(value->getString());
+                    break;
+                default:
+                    _output.append((char)0xF6);
+                    break;
+            }
+        }
+
+        private: void writeHead(int32 major, unsigned long long argument)
+        {
+            unsigned char bytes[9];
+            int32 length;
+            unsigned char type = (unsigned char)( major << 5 );
+            if ( argument < 24 )
+            {
+                bytes[0] = (unsigned char)( type | argument );
+                length = 1;
+            }
+            else if ( argument <= 0xFF )
+            {
+                bytes[0] = type | 24;
+                length = 2;
+            }
+            else if ( argument <= 0xFFFF )
+            {
+                bytes[0] = type | 25;
+                length = 3;
+            }
+            else if ( argument <= 0xFFFFFFFFULL )
+            {
+                bytes[0] = type | 26;
+                length = 5;
+            }
+            else
+            {
+                bytes[0] = type | 27;
+                length = 9;
+            }
+            // Arguments are big-endian.
+            for ( int32 i = length - 1 ; i >= 1 ; --i, argument >>= 8 )
+            {
+                bytes[i] = (unsigned char)argument;
+            }
+            _output.append((const char*)bytes, length);
+        }
+
+        private: void writeDouble(double number)
+        {
+            unsigned char bytes[9];
+            float single = (float)number;
+            if ( ( (double)single == number ) || ( number != number ) )
+            {
+                unsigned int bits;
+                memcpy(&bits, &single, sizeof(bits));
+                bytes[0] = 0xFA;
+                for ( int32 i = 4 ; i >= 1 ; --i, bits >>= 8 )
+                {
+                    bytes[i] = (unsigned char)bits;
+                }
+                _output.append((const char*)bytes, 5);
+                return;
+            }
+            unsigned long long bits;
+            memcpy(&bits, &number, sizeof(bits));
+            bytes[0] = 0xFB;
+            for ( int32 i = 8 ; i >= 1 ; --i, bits >>= 8 )
+            {
+                bytes[i] = (unsigned char)bits;
+            }
+            _output.append((const char*)bytes, 9);
+        }
+
+        private: void writeString(const GString& str)
+        {
+            const char* data = ( str != NULL ) ? str->getBytes() : "";
+            int32 length = ( str != NULL ) ? str->length() : 0;
+            if ( length >= 3 )
+            {
+                Entry& entry = find(data, length);
+                if ( NULL != entry.data )
+                {
+                    writeHead(MAJOR_TAG, TAG_STRINGREF);
+                    writeHead(MAJOR_UNSIGNED, (unsigned long long)entry.index);
+                    return;
+                }
+                if ( isReferenceable(length, _count) )
+                {
+                    _strings.push_back(str);
+                    entry.data = data;
+                    entry.length = length;
+                    entry.index = _count++;
+                    if ( _count * 2 > (int32)_table.size() )
+                    {
+                        grow();
+                    }
+                }
+            }
+            writeHead(MAJOR_TEXT, (unsigned long long)length);
+            _output.append(data, length);
+        }
+
+        /**
+         * Returns the entry holding the string or the empty slot where it belongs.
+         */
+        private: Entry& find(const char* data, int32 length)
+        {
+            unsigned int mask = (unsigned int)_table.size() - 1;
+            for ( unsigned int slot = JsonParser::hashKey(data, length) & mask ; ; slot = ( slot + 1 ) & mask )
+            {
+                Entry& entry = _table[slot];
+                if ( ( NULL == entry.data ) ||
+                    ( ( entry.length == length ) && ( 0 == memcmp(entry.data, data, length) ) ) )
+                {
+                    return entry;
+                }
+            }
+        }
+
+        private: void grow()
+        {
+            std::vector<Entry> old;
+            old.swap(_table);
+            Entry empty = { NULL, 0, 0 };
+            _table.assign(old.size() * 2, empty);
+            for ( size_t i = 0 ; i < old.size() ; ++i )
+            {
+                if ( NULL != old[i].data )
+                {
+                    find(old[i].data, old[i].length) = old[i];
+                }
+            }
+        }
+    };
+
+    private: class Decoder
+    {
+        private: const unsigned char* _data;
+
+        private: int32 _length;
+
+        private: int32 _position;
+
+        private: JsonHandler& _handler;
+
+        private: bool _stopped;
+
+        private: std::vector<StringView> _strings;
+
+        public: Decoder(const unsigned char* data, int32 length, JsonHandler& handler)
+            : _data(data), _length(length), _position(0), _handler(handler), _stopped(false)
+        {
+        }
+
+        public: bool decodeDocument()
+        {
+            bool valid = decodeValue(0, false);
+            // Handlers like JsonPrimitiveBuilder stop right after the last event of the document.
+            return valid && ( _position == _length );
+        }
+
+        /**
+         * Decodes one data item. Returns false if the data is malformed or the handler stopped.
+         */
+        private: bool decodeValue(int32 depth, bool isKey)
+        {
+            if ( _stopped || ( depth > JsonParser::MAX_DEPTH ) )
+            {
+                return false;
+            }
+            int32 major;
+            int32 info;
+            unsigned long long argument;
+            if ( !readHead(major, info, argument) )
+            {
+                return false;
+            }
+            if ( isKey && ( MAJOR_TEXT != major ) && ( MAJOR_BYTES != major ) && ( MAJOR_TAG != major ) )
+            {
+                return false;
+            }
+            switch ( major )
+            {
+                case MAJOR_UNSIGNED:
+                    return ( argument <= 9223372036854775807ULL ) ? emit(_handler.longValue((int64)argument))
+                        : emit(_handler.doubleValue((double)argument));
+                case MAJOR_NEGATIVE:
+                    return ( argument <= 9223372036854775807ULL ) ? emit(_handler.longValue(-1 - (int64)argument))
+                        : emit(_handler.doubleValue(-1.0 - (double)argument));
+                case MAJOR_BYTES:
+                case MAJOR_TEXT:
+                {
+                    if ( argument > (unsigned long long)( _length - _position ) )
+                    {
+                        return false;
+                    }
+                    StringView str((const char*)_data + _position, (int32)argument);
+                    _position += (int32)argument;
+                    if ( isReferenceable(str.length(), (int32)_strings.size()) )
+                    {
+                        _strings.push_back(str);
+                    }
+                    return emitString(str, isKey);
+                }
+                case MAJOR_ARRAY:
+                {
+                    if ( ( argument > (unsigned long long)( _length - _position ) ) || !emit(_handler.startArray()) )
+                    {
+                        return false;
+                    }
+                    for ( unsigned long long i = 0 ; i < argument ; ++i )
+                    {
+                        if ( !decodeValue(depth + 1, false) )
+                        {
+                            return false;
+                        }
+                    }
+                    return emit(_handler.endArray());
+                }
+                case MAJOR_MAP:
+                {
+                    if ( ( argument > (unsigned long long)( _length - _position ) ) || !emit(_handler.startObject()) )
+                    {
+                        return false;
+                    }
+                    for ( unsigned long long i = 0 ; i < argument ; ++i )
+                    {
+                        if ( !decodeValue(depth + 1, true) || !decodeValue(depth + 1, false) )
+                        {
+                            return false;
+                        }
+                    }
+                    return emit(_handler.endObject());
+                }
+                case MAJOR_TAG:
+                    if ( TAG_STRINGREF == argument )
+                    {
+                        if ( !readHead(major, info, argument) || ( MAJOR_UNSIGNED != major ) || ( argument >= _strings.size() ) )
+                        {
+                            return false;
+                        }
+                        return emitString(_strings[(size_t)argument], isKey);
+                    }
+                    if ( isKey )
+                    {
+                        return false;
+                    }
+                    if ( TAG_STRINGREF_NAMESPACE == argument )
+                    {
+                        // Nested namespaces start an empty table and restore the outer one afterwards.
+                        std::vector<StringView> outer;
+                        outer.swap(_strings);
+                        bool valid = decodeValue(depth + 1, false);
+                        _strings.swap(outer);
+                        return valid;
+                    }
+                    // Other tags (including the self-described marker) carry no meaning for primitives.
+                    return decodeValue(depth + 1, false);
+                default:
+                    return decodeSimple(info, argument);
+            }
+        }
+
+        private: bool decodeSimple(int32 info, unsigned long long argument)
+        {
+            switch ( info )
+            {
+                case 20:
+                    return emit(_handler.boolValue(false));
+                case 21:
+                    return emit(_handler.boolValue(true));
+                case 22:
+                case 23:
+                    return emit(_handler.nullValue());
+                case 25:
+                    return emit(_handler.doubleValue(halfToDouble((unsigned int)argument)));
+                case 26:
+                {
+                    unsigned int bits = (unsigned int)argument;
+                    float single;
+                    memcpy(&single, &bits, sizeof(single));
+                    return emit(_handler.doubleValue(single));
+                }
+                case 27:
+                {
+                    double number;
+                    memcpy(&number, &argument, sizeof(number));
+                    return emit(_handler.doubleValue(number));
+                }
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * Reads initial byte and argument of a data item. Indefinite lengths are not supported.
+         */
+        private: bool readHead(int32& major, int32& info, unsigned long long& argument)
+        {
+            if ( _position >= _length )
+            {
+                return false;
+            }
+            unsigned char initial = _data[_position++];
+            major = initial >> 5;
+            info = initial & 0x1F;
+            if ( info < 24 )
+            {
+                argument = (unsigned long long)info;
+                return true;
+            }
+            if ( info > 27 )
+            {
+                return false;
+            }
+            int32 size = 1 << ( info - 24 );
+            if ( size > _length - _position )
+            {
+                return false;
+            }
+            argument = 0;
+            for ( int32 i = 0 ; i < size ; ++i )
+            {
+                argument = ( argument << 8 ) | _data[_position++];
+            }
+            return true;
+        }
+
+        private: bool emitString(const StringView& str, bool isKey)
+        {
+            return emit(isKey ? _handler.key(str) : _handler.string(str));
+        }
+
+        private: bool emit(bool proceed)
+        {
+            if ( !proceed )
+            {
+                _stopped = true;
+            }
+            // Stopping after the last event of the document is checked by decodeDocument().
+            return !_stopped || ( _position == _length );
+        }
+
+        private: static double halfToDouble(unsigned int half)
+        {
+            int32 exponent = ( half >> 10 ) & 0x1F;
+            int32 mantissa = half & 0x3FF;
+            double value;
+            if ( 0 == exponent )
+            {
+                value = ldexp((double)mantissa, -24);
+            }
+            else if ( 31 == exponent )
+            {
+                value = ( 0 == mantissa ) ? HUGE_VAL : NAN;
+            }
+            else
+            {
+                value = ldexp((double)( mantissa + 1024 ), exponent - 25);
+            }
+            return ( half & 0x8000 ) ? -value : value;
+        }
+    };
+
+    /**
+     * Builds GPrimitive trees sharing one string object per distinct string. References to the same
+     * string are views with the same address, so the cache is keyed by address.
+     */
+    private: class SharedStringBuilder : public JsonPrimitiveBuilder
+    {
+        private: static const int32 CACHE_SIZE = 256;
+
+        private: const char* _addresses[CACHE_SIZE];
+
+        private: GString _strings[CACHE_SIZE];
+
+        public: SharedStringBuilder()
+        {
+            memset(_addresses, 0, sizeof(_addresses));
+        }
+
+        protected: virtual GString createString(const StringView& value)
+        {
+            int32 slot = (int32)( ( (size_t)value.data() >> 2 ) & ( CACHE_SIZE - 1 ) );
+            if ( ( _addresses[slot] == value.data() ) && ( _strings[slot]->length() == value.length() ) )
+            {
+                return _strings[slot];
+            }
+            _addresses[slot] = value.data();
+            _strings[slot] = value.toString();
+            return _strings[slot];
+        }
+    };
+};
+
+}
+
+#endif // !PRIMITIVECODEC_H__GLYMPSE__
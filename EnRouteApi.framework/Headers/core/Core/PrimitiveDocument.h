@@ -0,0 +1,2070 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef PRIMITIVEDOCUMENT_H__GLYMPSE__
+#define PRIMITIVEDOCUMENT_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Object key stored in PrimitiveDocument arena. Keys are unique within a document, so members of
+ * different objects with the same name share one PrimitiveKey and can be compared by address.
+ */
+struct PrimitiveKey
+{
+    const char* chars;
+
+    int32 length;
+
+    unsigned int hash;
+
+    /**
+     * One-based index of the string object in the document string table, 0 if none has been created yet.
+     */
+    int32 cached;
+};
+
+struct PrimitiveNode;
+
+struct PrimitiveMember
+{
+    PrimitiveKey* key;
+
+    PrimitiveNode* value;
+};
+
+class PrimitiveDocument;
+
+/**
+ * Container of a lazily parsed document which has not been built yet.
+ */
+struct PrimitiveSpan
+{
+    PrimitiveDocument* document;
+
+    /**
+     * Number of the container in the structural index of the document source.
+     */
+    int32 container;
+};
+
+/**
+ * Value stored in PrimitiveDocument arena.
+ *
+ * Members of objects and elements of arrays are kept in flat arrays in insertion order. Objects with more
+ * than PrimitiveDocument::INDEX_THRESHOLD members additionally get a hashed index of member positions.
+ *
+ * Every node belongs to at most one container, which it refers to, so that changes can invalidate the
+ * content hashes cached along the way to the root (see PrimitiveDocument::contentHash()).
+ */
+struct PrimitiveNode
+{
+    /**
+     * One of CC::PRIMITIVE_TYPE_* constants.
+     */
+    int32 type;
+
+    /**
+     * Number of elements or members of containers, length of strings. -1 for containers which have not
+     * been built yet (see PrimitiveDocument::expand()).
+     */
+    int32 size;
+
+    union
+    {
+        /**
+         * Number of allocated element or member slots of containers.
+         */
+        int32 capacity;
+
+        /**
+         * One-based index of the string object in the document string table, 0 if none has been created yet.
+         */
+        int32 cached;
+    };
+
+    /**
+     * Content hash of the subtree, 0 if it has not been computed since the last change.
+     */
+    unsigned int hash;
+
+    union
+    {
+        double doubleValue;
+        int64 longValue;
+        bool boolValue;
+        const char* chars;
+        PrimitiveNode** elements;
+        PrimitiveMember* members;
+        PrimitiveSpan* span;
+    };
+
+    /**
+     * Open addressing table of one-based member positions of large objects, NULL for other nodes.
+     * The first entry holds the mask of the table, slots follow.
+     */
+    int32* index;
+
+    /**
+     * Container holding the node, NULL for roots and detached nodes.
+     */
+    PrimitiveNode* parent;
+};
+
+class DocumentPrimitive;
+
+/**
+ * Primitive tree allocated in a single arena.
+ *
+ * All nodes, keys and string characters of a document live in one Arena owned by the document. Nodes
+ * are plain structures without reference counters, so creating a tree costs a handful of pointer bumps
+ * per value and destroying it releases a few large chunks regardless of the number of nodes.
+ *
+ * Documents are accessed through DocumentPrimitive handles implementing IPrimitive. Handles are created
+ * on demand by get(), getArray() etc. and keep the whole document alive, so subtrees handed out to other
+ * code stay valid after the root is released. Handles to the same node share its state: modifications
+ * made through one are visible through all of them and through the root.
+ *
+ * Subtrees crossing document boundaries are copied when they are written. Putting a primitive created
+ * by CoreFactory, or a node of another document, into a document stores a copy of it in the arena;
+ * later changes made to the source are not reflected in the document. Putting a detached node of the
+ * same document (one that was removed from its container, or a root created by the document) links it
+ * without copying; nodes still held by a container are copied, so that no node has two containers.
+ *
+ * Every node caches a content hash of its subtree once it is computed (see contentHash()). Changes clear
+ * the hashes of the changed node and its ancestors only, so rehashing after a small change costs time
+ * proportional to the depth of the change rather than to the size of the document, and documents which
+ * differ can usually be told apart in constant time.
+ *
+ * Documents are append-only: nodes of removed or replaced values, and string objects passed to set()
+ * and put(), are kept until the document is destroyed, as handles to them may still be around.
+ * A document modified over and over keeps growing (see getArenaSize()); rebuild such a document with
+ * copy() from time to time, or keep long-lived mutable state in CoreFactory primitives instead.
+ *
+ * Documents are not thread safe, and unlike CoreFactory primitives not even for reads: reading caches
+ * string objects and content hashes in the nodes, and builds containers of lazily parsed documents.
+ * A document (and every handle into it) must be used by one thread at a time. Handing it over to another
+ * thread is fine, as long as the handover synchronizes (e.g. posting to IHandler).
+ *
+ * Documents created by parseLazy() keep the source text and its structural index, and build containers
+ * only when they are accessed for the first time. Until then a container is a single node referring to
+ * its location in the text; nothing nested in it is allocated. Strings without escape sequences refer
+ * to the source text instead of being copied.
+ */
+class PrimitiveDocument : public Common< ICommon >
+{
+    private: Arena _arena;
+
+    /**
+     * String objects handed out by getString() and getKeyString(), or passed in by set() and put().
+     */
+    private: std::vector< GString > _strings;
+
+    /**
+     * Open addressing table of all keys in the document.
+     */
+    private: std::vector< PrimitiveKey* > _keys;
+
+    private: int32 _keyCount;
+
+    /**
+     * Source text of lazily parsed documents and its structural index.
+     */
+    private: const char* _source;
+
+    private: int32 _sourceLength;
+
+    private: GString _sourceString;
+
+    private: JsonParser::Index _index;
+
+    /**
+     * Objects with more members than this get a hashed index. Smaller ones are searched linearly,
+     * which is faster for the few members they typically have.
+     */
+    public: static const int32 INDEX_THRESHOLD = 8;
+
+    private: explicit PrimitiveDocument(int32 arenaSize)
+        : _arena(arenaSize)
+        , _keyCount(0)
+        , _source(NULL)
+        , _sourceLength(0)
+    {
+    }
+
+    /**
+     * @name Creation
+     */
+
+    /**
+     * Parses JSON text into a new document. Returns the root or NULL if the text is not valid JSON.
+     */
+    public: static GPrimitive parse(const char* json, int32 length);
+
+    /**
+     * This method is provided for convenience.
+     * See parse(const char*, int32) for more details.
+     */
+    public: static GPrimitive parse(const StringView& json)
+    {
+        return parse(json.data(), json.length());
+    }
+
+    /**
+     * Parses JSON text into a new document building containers on first access. The characters are copied.
+     * Returns the root or NULL if the text is not valid JSON.
+     *
+     * The whole text is validated up front, so errors are never discovered later. Only the root container
+     * is built immediately; other containers are built when they are reached through get(), getArray(),
+     * getKeys() and the like, one level at a time. These reads modify the document, so it must not be
+     * read from several threads at once (see the class description).
+     */
+    public: static GPrimitive parseLazy(const char* json, int32 length);
+
+    /**
+     * This method is provided for convenience.
+     * See parseLazy(const char*, int32) for more details. The string is kept instead of copying it.
+     */
+    public: static GPrimitive parseLazy(const GString& json);
+
+    /**
+     * Creates a new document with empty root of the specified type (see CC::PRIMITIVE_TYPE_*).
+     */
+    public: static GPrimitive create(int32 type);
+
+    /**
+     * Copies source tree into a new document.
+     */
+    public: static GPrimitive copy(const GPrimitive& source);
+
+    /**
+     * Builds container created by parseLazy() if it has not been built yet. Returns node.
+     *
+     * Code reading size, members or elements of a container must call this first. Methods of the document
+     * do so themselves. The type of a node is always valid.
+     */
+    public: static inline PrimitiveNode* expand(PrimitiveNode* node)
+    {
+        if ( node->size < 0 )
+        {
+            node->span->document->build(node);
+        }
+        return node;
+    }
+
+    /**
+     * Returns number of bytes reserved by the arena.
+     */
+    public: size_t getArenaSize() const
+    {
+        return _arena.getReservedSize();
+    }
+
+    /**
+     * @name Node Access
+     *
+     * Used by DocumentPrimitive. All nodes passed in must belong to this document.
+     */
+
+    public: PrimitiveNode* createNode(int32 type)
+    {
+        PrimitiveNode* node = _arena.allocateArray< PrimitiveNode >(1);
+        node->hash = 0;
+        node->parent = NULL;
+        reset(node, type);
+        return node;
+    }
+
+    /**
+     * Turns node into an empty value of the specified type. The node stays in its container.
+     */
+    public: static void reset(PrimitiveNode* node, int32 type)
+    {
+        invalidate(node);
+        node->type = type;
+        node->size = 0;
+        node->capacity = 0;
+        node->longValue = 0;
+        node->index = NULL;
+    }
+
+    /**
+     * Stores copy of the characters in node.
+     */
+    public: void setString(PrimitiveNode* node, const char* chars, int32 length)
+    {
+        reset(node, CC::PRIMITIVE_TYPE_STRING);
+        node->chars = _arena.copy(chars, length);
+        node->size = length;
+    }
+
+    /**
+     * Stores string object in node without copying its characters. NULL turns the node into null.
+     */
+    public: void setString(PrimitiveNode* node, const GString& value)
+    {
+        if ( value == NULL )
+        {
+            reset(node, CC::PRIMITIVE_TYPE_NULL);
+            return;
+        }
+        reset(node, CC::PRIMITIVE_TYPE_STRING);
+        node->chars = value->getBytes();
+        node->size = value->length();
+        node->cached = retainString(value);
+    }
+
+    /**
+     * Returns string object for string node, NULL for other types. The object is created on first access.
+     */
+    public: GString getString(PrimitiveNode* node)
+    {
+        if ( CC::PRIMITIVE_TYPE_STRING != node->type )
+        {
+            return NULL;
+        }
+        if ( 0 == node->cached )
+        {
+            node->cached = retainString(CoreFactory::createString(node->chars, node->size));
+        }
+        return _strings[node->cached - 1];
+    }
+
+    /**
+     * Returns string object for key. The object is created on first access.
+     */
+    public: GString getKeyString(PrimitiveKey* key)
+    {
+        if ( 0 == key->cached )
+        {
+            key->cached = retainString(CoreFactory::createString(key->chars, key->length));
+        }
+        return _strings[key->cached - 1];
+    }
+
+    /**
+     * Value conversions. Longs and doubles are converted into each other, other types yield 0 or false.
+     */
+
+    public: static double toDouble(const PrimitiveNode* node)
+    {
+        switch ( node->type )
+        {
+            case CC::PRIMITIVE_TYPE_DOUBLE:
+                return node->doubleValue;
+            case CC::PRIMITIVE_TYPE_LONG:
+                return (double)node->longValue;
+            default:
+                return 0;
+        }
+    }
+
+    public: static int64 toLong(const PrimitiveNode* node)
+    {
+        switch ( node->type )
+        {
+            case CC::PRIMITIVE_TYPE_LONG:
+                return node->longValue;
+            case CC::PRIMITIVE_TYPE_DOUBLE:
+                return (int64)node->doubleValue;
+            default:
+                return 0;
+        }
+    }
+
+    public: static bool toBool(const PrimitiveNode* node)
+    {
+        return ( CC::PRIMITIVE_TYPE_BOOLEAN == node->type ) && node->boolValue;
+    }
+
+    /**
+     * Returns the key with the specified characters, adding a copy of them to the document if needed.
+     */
+    public: PrimitiveKey* internKey(const char* chars, int32 length, unsigned int hash)
+    {
+        PrimitiveKey** slot = findKeySlot(chars, length, hash);
+        if ( NULL == *slot )
+        {
+            *slot = addKey(_arena.copy(chars, length), length, hash);
+            slot = growKeys(slot);
+        }
+        return *slot;
+    }
+
+    /**
+     * Returns the key with the same characters as key, adding it to the document if needed.
+     */
+    public: PrimitiveKey* internKey(const GString& key)
+    {
+        const char* chars = key->getBytes();
+        int32 length = key->length();
+        unsigned int hash = JsonParser::hashKey(chars, length);
+        PrimitiveKey** slot = findKeySlot(chars, length, hash);
+        if ( NULL == *slot )
+        {
+            *slot = addKey(chars, length, hash);
+            (*slot)->cached = retainString(key);
+            slot = growKeys(slot);
+        }
+        return *slot;
+    }
+
+    /**
+     * Returns the key with the specified characters or NULL if no object in the document has such a member.
+     */
+    public: PrimitiveKey* findKey(const char* chars, int32 length)
+    {
+        return ( 0 == _keyCount ) ? NULL : *findKeySlot(chars, length, JsonParser::hashKey(chars, length));
+    }
+
+    /**
+     * Returns index of member with the specified key or -1 if the object has no such member.
+     */
+    public: static int32 findMember(PrimitiveNode* object, const PrimitiveKey* key)
+    {
+        expand(object);
+        const PrimitiveMember* members = object->members;
+        const int32* index = object->index;
+        if ( NULL != index )
+        {
+            int32 mask = index[0];
+            for ( int32 slot = key->hash & mask ; 0 != index[slot + 1] ; slot = ( slot + 1 ) & mask )
+            {
+                int32 position = index[slot + 1] - 1;
+                if ( isSameKey(members[position].key, key) )
+                {
+                    return position;
+                }
+            }
+            return -1;
+        }
+        for ( int32 i = 0, size = object->size ; i < size ; ++i )
+        {
+            if ( isSameKey(members[i].key, key) )
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Adds member to object or replaces the value of existing one.
+     */
+    public: void putMember(PrimitiveNode* object, PrimitiveKey* key, PrimitiveNode* value)
+    {
+        int32 index = findMember(object, key);
+        invalidate(object);
+        if ( index >= 0 )
+        {
+            object->members[index].value->parent = NULL;
+            object->members[index].value = value;
+            value->parent = object;
+            return;
+        }
+        if ( object->size == object->capacity )
+        {
+            object->members = grow(object->members, object->size, object->capacity);
+        }
+        PrimitiveMember& member = object->members[object->size++];
+        member.key = key;
+        member.value = value;
+        value->parent = object;
+        if ( NULL != object->index )
+        {
+            if ( object->size * 2 > object->index[0] + 1 )
+            {
+                buildIndex(object);
+            }
+            else
+            {
+                addToIndex(object->index, key->hash, object->size - 1);
+            }
+        }
+        else if ( object->size > INDEX_THRESHOLD )
+        {
+            buildIndex(object);
+        }
+    }
+
+    public: void removeMember(PrimitiveNode* object, int32 index)
+    {
+        expand(object);
+        invalidate(object);
+        PrimitiveMember* members = object->members;
+        members[index].value->parent = NULL;
+        memmove(members + index, members + index + 1, ( object->size - index - 1 ) * sizeof(PrimitiveMember));
+        --object->size;
+        if ( NULL != object->index )
+        {
+            // Positions past the removed member have shifted.
+            object->index = NULL;
+            if ( object->size > INDEX_THRESHOLD )
+            {
+                buildIndex(object);
+            }
+        }
+    }
+
+    /**
+     * Inserts element into array at index (0..size).
+     */
+    public: void insertElement(PrimitiveNode* array, int32 index, PrimitiveNode* value)
+    {
+        expand(array);
+        if ( array->size == array->capacity )
+        {
+            array->elements = grow(array->elements, array->size, array->capacity);
+        }
+        invalidate(array);
+        PrimitiveNode** elements = array->elements;
+        memmove(elements + index + 1, elements + index, ( array->size - index ) * sizeof(PrimitiveNode*));
+        elements[index] = value;
+        value->parent = array;
+        ++array->size;
+    }
+
+    public: void appendElement(PrimitiveNode* array, PrimitiveNode* value)
+    {
+        expand(array);
+        if ( array->size == array->capacity )
+        {
+            array->elements = grow(array->elements, array->size, array->capacity);
+        }
+        invalidate(array);
+        array->elements[array->size++] = value;
+        value->parent = array;
+    }
+
+    /**
+     * Replaces element at index (0..size-1).
+     */
+    public: static void replaceElement(PrimitiveNode* array, int32 index, PrimitiveNode* value)
+    {
+        expand(array);
+        invalidate(array);
+        array->elements[index]->parent = NULL;
+        array->elements[index] = value;
+        value->parent = array;
+    }
+
+    public: static void removeElement(PrimitiveNode* array, int32 index)
+    {
+        expand(array);
+        invalidate(array);
+        PrimitiveNode** elements = array->elements;
+        elements[index]->parent = NULL;
+        memmove(elements + index, elements + index + 1, ( array->size - index - 1 ) * sizeof(PrimitiveNode*));
+        --array->size;
+    }
+
+    /**
+     * Moves contents of a detached node into node, which keeps its place in the tree.
+     */
+    public: static void assign(PrimitiveNode* node, PrimitiveNode* source)
+    {
+        PrimitiveNode* parent = node->parent;
+        invalidate(node);
+        *node = *source;
+        node->parent = parent;
+        if ( CC::PRIMITIVE_TYPE_OBJECT == node->type )
+        {
+            for ( int32 i = 0 ; i < node->size ; ++i )
+            {
+                node->members[i].value->parent = node;
+            }
+        }
+        else if ( CC::PRIMITIVE_TYPE_ARRAY == node->type )
+        {
+            for ( int32 i = 0 ; i < node->size ; ++i )
+            {
+                node->elements[i]->parent = node;
+            }
+        }
+    }
+
+    /**
+     * Returns node for value. Detached nodes of this document are returned as is, everything else is copied.
+     */
+    public: PrimitiveNode* import(const GPrimitive& value);
+
+    /**
+     * Copies node of another document (or of this one) into this document.
+     */
+    public: PrimitiveNode* copyNode(PrimitiveDocument& source, PrimitiveNode* node)
+    {
+        expand(node);
+        PrimitiveNode* copy = createNode(node->type);
+        switch ( node->type )
+        {
+            case CC::PRIMITIVE_TYPE_OBJECT:
+            {
+                copy->capacity = node->size;
+                copy->members = _arena.allocateArray< PrimitiveMember >(node->size);
+                copy->size = node->size;
+                for ( int32 i = 0 ; i < node->size ; ++i )
+                {
+                    PrimitiveKey* key = node->members[i].key;
+                    copy->members[i].key = ( &source == this ) ? key
+                        : ( ( 0 != key->cached ) ? internKey(source._strings[key->cached - 1])
+                            : internKey(key->chars, key->length, key->hash) );
+                    copy->members[i].value = copyNode(source, node->members[i].value);
+                    copy->members[i].value->parent = copy;
+                }
+                if ( copy->size > INDEX_THRESHOLD )
+                {
+                    buildIndex(copy);
+                }
+                break;
+            }
+            case CC::PRIMITIVE_TYPE_ARRAY:
+            {
+                copy->capacity = node->size;
+                copy->elements = _arena.allocateArray< PrimitiveNode* >(node->size);
+                copy->size = node->size;
+                for ( int32 i = 0 ; i < node->size ; ++i )
+                {
+                    copy->elements[i] = copyNode(source, node->elements[i]);
+                    copy->elements[i]->parent = copy;
+                }
+                break;
+            }
+            case CC::PRIMITIVE_TYPE_STRING:
+                if ( 0 != node->cached )
+                {
+                    setString(copy, source._strings[node->cached - 1]);
+                }
+                else
+                {
+                    setString(copy, node->chars, node->size);
+                }
+                break;
+            default:
+                copy->longValue = node->longValue;
+                break;
+        }
+        copy->hash = node->hash;
+        return copy;
+    }
+
+    /**
+     * Compares two trees of nodes, which might belong to different documents.
+     */
+    public: static bool equals(PrimitiveNode* lhs, PrimitiveNode* rhs)
+    {
+        if ( lhs == rhs )
+        {
+            return true;
+        }
+        // Hashes computed earlier tell most different subtrees apart without walking them.
+        if ( ( 0 != lhs->hash ) && ( 0 != rhs->hash ) && ( lhs->hash != rhs->hash ) )
+        {
+            return false;
+        }
+        expand(lhs);
+        expand(rhs);
+        if ( ( lhs->type != rhs->type ) || ( lhs->size != rhs->size ) )
+        {
+            return false;
+        }
+        switch ( lhs->type )
+        {
+            case CC::PRIMITIVE_TYPE_OBJECT:
+                for ( int32 i = 0 ; i < lhs->size ; ++i )
+                {
+                    int32 index = findMember(rhs, lhs->members[i].key);
+                    if ( ( index < 0 ) || !equals(lhs->members[i].value, rhs->members[index].value) )
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            case CC::PRIMITIVE_TYPE_ARRAY:
+                for ( int32 i = 0 ; i < lhs->size ; ++i )
+                {
+                    if ( !equals(lhs->elements[i], rhs->elements[i]) )
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            case CC::PRIMITIVE_TYPE_STRING:
+                return 0 == memcmp(lhs->chars, rhs->chars, lhs->size);
+            case CC::PRIMITIVE_TYPE_DOUBLE:
+                return lhs->doubleValue == rhs->doubleValue;
+            case CC::PRIMITIVE_TYPE_LONG:
+                return lhs->longValue == rhs->longValue;
+            case CC::PRIMITIVE_TYPE_BOOLEAN:
+                return lhs->boolValue == rhs->boolValue;
+            default:
+                return true;
+        }
+    }
+
+    /**
+     * Compares node with primitive of any implementation.
+     */
+    public: bool equals(PrimitiveNode* node, IPrimitive* other)
+    {
+        expand(node);
+        if ( node->type != other->type() )
+        {
+            return false;
+        }
+        switch ( node->type )
+        {
+            case CC::PRIMITIVE_TYPE_OBJECT:
+            {
+                if ( node->size != other->size() )
+                {
+                    return false;
+                }
+                for ( int32 i = 0 ; i < node->size ; ++i )
+                {
+                    GPrimitive value = other->get(getKeyString(node->members[i].key));
+                    if ( ( value == NULL ) || !equals(node->members[i].value, value.get()) )
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case CC::PRIMITIVE_TYPE_ARRAY:
+            {
+                if ( node->size != other->size() )
+                {
+                    return false;
+                }
+                for ( int32 i = 0 ; i < node->size ; ++i )
+                {
+                    GPrimitive value = other->get(i);
+                    if ( ( value == NULL ) || !equals(node->elements[i], value.get()) )
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case CC::PRIMITIVE_TYPE_STRING:
+            {
+                GString value = other->getString();
+                return ( value != NULL ) && ( value->length() == node->size ) &&
+                    ( 0 == memcmp(value->getBytes(), node->chars, node->size) );
+            }
+            case CC::PRIMITIVE_TYPE_DOUBLE:
+                return node->doubleValue == other->getDouble();
+            case CC::PRIMITIVE_TYPE_LONG:
+                return node->longValue == other->getLong();
+            case CC::PRIMITIVE_TYPE_BOOLEAN:
+                return node->boolValue == other->getBool();
+            default:
+                return true;
+        }
+    }
+
+    /**
+     * @name Content Hashes
+     *
+     * Hashes depend only on the contents of a subtree: equal subtrees have equal hashes regardless of
+     * the document, the order of object members or the implementation of IPrimitive. Different hashes
+     * thus prove that subtrees differ.
+     */
+
+    /**
+     * Returns content hash of the subtree, computing it for the nodes whose hashes are not cached.
+     */
+    public: static unsigned int contentHash(PrimitiveNode* node)
+    {
+        if ( 0 != node->hash )
+        {
+            return node->hash;
+        }
+        expand(node);
+        unsigned int content = 0;
+        switch ( node->type )
+        {
+            case CC::PRIMITIVE_TYPE_OBJECT:
+                for ( int32 i = 0 ; i < node->size ; ++i )
+                {
+                    content += hashMember(node->members[i].key->hash, contentHash(node->members[i].value));
+                }
+                break;
+            case CC::PRIMITIVE_TYPE_ARRAY:
+                for ( int32 i = 0 ; i < node->size ; ++i )
+                {
+                    content = hashElement(content, contentHash(node->elements[i]));
+                }
+                break;
+            case CC::PRIMITIVE_TYPE_STRING:
+                content = JsonParser::hashKey(node->chars, node->size);
+                break;
+            case CC::PRIMITIVE_TYPE_DOUBLE:
+                content = hashDouble(node->doubleValue);
+                break;
+            case CC::PRIMITIVE_TYPE_LONG:
+                content = hashLong(node->longValue);
+                break;
+            case CC::PRIMITIVE_TYPE_BOOLEAN:
+                content = node->boolValue ? 1 : 0;
+                break;
+            default:
+                break;
+        }
+        node->hash = hashValue(node->type, node->size, content);
+        return node->hash;
+    }
+
+    /**
+     * Returns content hash of a primitive of any implementation. Hashes of document nodes are cached,
+     * others are computed on every call.
+     */
+    public: static unsigned int contentHash(IPrimitive* value);
+
+    /**
+     * Clears cached hashes of node and its ancestors. Called whenever node changes.
+     */
+    public: static inline void invalidate(PrimitiveNode* node)
+    {
+        // Hashes are computed bottom up, so ancestors of a node without hash have none either.
+        while ( ( NULL != node ) && ( 0 != node->hash ) )
+        {
+            node->hash = 0;
+            node = node->parent;
+        }
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static inline unsigned int mix(unsigned int hash)
+    {
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+    private: static inline unsigned int hashLong(int64 value)
+    {
+        return mix((unsigned int)value ^ mix((unsigned int)( (unsigned long long)value >> 32 )));
+    }
+
+    private: static inline unsigned int hashDouble(double value)
+    {
+        // 0.0 and -0.0 are equal.
+        int64 bits = 0;
+        if ( 0 != value )
+        {
+            memcpy(&bits, &value, sizeof(bits));
+        }
+        return hashLong(bits);
+    }
+
+    /**
+     * Members are combined by addition, so that their order does not matter.
+     */
+    private: static inline unsigned int hashMember(unsigned int key, unsigned int value)
+    {
+        return mix(key * 0x9e3779b9u + value);
+    }
+
+    private: static inline unsigned int hashElement(unsigned int content, unsigned int element)
+    {
+        return content * 0x01000193u + element;
+    }
+
+    /**
+     * Returns final hash, never 0.
+     */
+    private: static inline unsigned int hashValue(int32 type, int32 size, unsigned int content)
+    {
+        unsigned int hash = mix(content ^ mix((unsigned int)type * 0x9e3779b9u + (unsigned int)size));
+        return ( 0 != hash ) ? hash : 1;
+    }
+
+    /**
+     * Builds deferred container in place. Nested containers are deferred again.
+     */
+    private: void build(PrimitiveNode* node)
+    {
+        int32 container = node->span->container;
+        DocumentBuilder builder(*this, node);
+        PrimitiveNode* result = NULL;
+        if ( !JsonParser::parse(_source, _sourceLength, _index, container, builder, result) )
+        {
+            // The text was validated by parseLazy(), so this is not expected to happen.
+            reset(node, node->type);
+        }
+    }
+
+    private: inline bool isSource(const char* chars) const
+    {
+        return ( chars >= _source ) && ( chars < _source + _sourceLength );
+    }
+
+    private: int32 retainString(const GString& value)
+    {
+        _strings.push_back(value);
+        return (int32)_strings.size();
+    }
+
+    /**
+     * Compares keys by address first and by characters if the keys belong to different documents.
+     */
+    public: static inline bool isSameKey(const PrimitiveKey* lhs, const PrimitiveKey* rhs)
+    {
+        return ( lhs == rhs ) || ( ( lhs->hash == rhs->hash ) && ( lhs->length == rhs->length ) &&
+            ( 0 == memcmp(lhs->chars, rhs->chars, lhs->length) ) );
+    }
+
+    private: PrimitiveKey* addKey(const char* chars, int32 length, unsigned int hash)
+    {
+        PrimitiveKey* key = _arena.allocateArray< PrimitiveKey >(1);
+        key->chars = chars;
+        key->length = length;
+        key->hash = hash;
+        key->cached = 0;
+        ++_keyCount;
+        return key;
+    }
+
+    /**
+     * Returns slot holding the key with the specified characters or empty slot where it belongs.
+     */
+    private: PrimitiveKey** findKeySlot(const char* chars, int32 length, unsigned int hash)
+    {
+        if ( _keys.empty() )
+        {
+            _keys.resize(16);
+        }
+        size_t mask = _keys.size() - 1;
+        for ( size_t index = hash & mask ; ; index = ( index + 1 ) & mask )
+        {
+            PrimitiveKey* key = _keys[index];
+            if ( ( NULL == key ) || ( ( key->hash == hash ) && ( key->length == length ) &&
+                ( 0 == memcmp(key->chars, chars, length) ) ) )
+            {
+                return &_keys[index];
+            }
+        }
+    }
+
+    /**
+     * Doubles the key table once it is half full. Returns the new location of the slot.
+     */
+    private: PrimitiveKey** growKeys(PrimitiveKey** slot)
+    {
+        if ( _keyCount * 2 <= (int32)_keys.size() )
+        {
+            return slot;
+        }
+        PrimitiveKey* added = *slot;
+        std::vector< PrimitiveKey* > keys(_keys.size() * 2);
+        keys.swap(_keys);
+        PrimitiveKey** result = NULL;
+        for ( size_t i = 0 ; i < keys.size() ; ++i )
+        {
+            if ( NULL != keys[i] )
+            {
+                PrimitiveKey** target = findKeySlot(keys[i]->chars, keys[i]->length, keys[i]->hash);
+                *target = keys[i];
+                if ( keys[i] == added )
+                {
+                    result = target;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Creates index of object members with at least twice as many slots as there are members.
+     */
+    private: void buildIndex(PrimitiveNode* object)
+    {
+        int32 slots = 16;
+        while ( slots < object->size * 2 )
+        {
+            slots *= 2;
+        }
+        int32* index = _arena.allocateArray< int32 >(slots + 1);
+        memset(index, 0, ( slots + 1 ) * sizeof(int32));
+        index[0] = slots - 1;
+        for ( int32 i = 0 ; i < object->size ; ++i )
+        {
+            addToIndex(index, object->members[i].key->hash, i);
+        }
+        object->index = index;
+    }
+
+    private: static void addToIndex(int32* index, unsigned int hash, int32 position)
+    {
+        int32 mask = index[0];
+        int32 slot = hash & mask;
+        while ( 0 != index[slot + 1] )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        index[slot + 1] = position + 1;
+    }
+
+    /**
+     * Moves items into a twice larger block of the arena.
+     */
+    private: template< class T > T* grow(T* items, int32 size, int32& capacity)
+    {
+        capacity = ( capacity < 4 ) ? 4 : capacity * 2;
+        T* result = _arena.allocateArray< T >(capacity);
+        if ( size > 0 )
+        {
+            memcpy(result, items, size * sizeof(T));
+        }
+        return result;
+    }
+
+    /**
+     * Builds nodes for JsonParser.
+     *
+     * Members and elements of open containers are collected on scratch stacks and moved into the arena
+     * when the container is closed, so that each container occupies a single block of exactly the right size.
+     * While a container is open, its capacity holds the position of its first pending item on the stack.
+     *
+     * For lazily parsed documents all containers nested in the one being built are deferred, and strings
+     * found in the source text as is are not copied.
+     */
+    private: class DocumentBuilder
+    {
+        public: typedef PrimitiveNode* Value;
+
+        public: typedef PrimitiveKey* Key;
+
+        private: PrimitiveDocument& _document;
+
+        /**
+         * Node to build the root container in, NULL to create a new one.
+         */
+        private: PrimitiveNode* _root;
+
+        private: std::vector< PrimitiveMember > _members;
+
+        private: std::vector< PrimitiveNode* > _elements;
+
+        public: explicit DocumentBuilder(PrimitiveDocument& document, PrimitiveNode* root = NULL)
+            : _document(document)
+            , _root(root)
+        {
+        }
+
+        public: PrimitiveNode* createContainer(bool isObject)
+        {
+            int32 type = isObject ? CC::PRIMITIVE_TYPE_OBJECT : CC::PRIMITIVE_TYPE_ARRAY;
+            PrimitiveNode* node = _root;
+            if ( NULL != node )
+            {
+                reset(node, type);
+                _root = NULL;
+            }
+            else
+            {
+                node = _document.createNode(type);
+            }
+            node->capacity = (int32)( isObject ? _members.size() : _elements.size() );
+            return node;
+        }
+
+        public: bool defer(int32)
+        {
+            return NULL != _document._source;
+        }
+
+        public: PrimitiveNode* createDeferred(bool isObject, int32 container)
+        {
+            PrimitiveNode* node = _document.createNode(isObject ? CC::PRIMITIVE_TYPE_OBJECT : CC::PRIMITIVE_TYPE_ARRAY);
+            node->size = -1;
+            node->span = _document._arena.allocateArray< PrimitiveSpan >(1);
+            node->span->document = &_document;
+            node->span->container = container;
+            return node;
+        }
+
+        public: PrimitiveKey* createKey(const char* chars, int32 length)
+        {
+            return _document.internKey(chars, length, JsonParser::hashKey(chars, length));
+        }
+
+        public: PrimitiveNode* createString(const char* chars, int32 length)
+        {
+            PrimitiveNode* node = _document.createNode(CC::PRIMITIVE_TYPE_STRING);
+            if ( _document.isSource(chars) )
+            {
+                node->chars = chars;
+                node->size = length;
+            }
+            else
+            {
+                _document.setString(node, chars, length);
+            }
+            return node;
+        }
+
+        public: PrimitiveNode* createLong(int64 value)
+        {
+            PrimitiveNode* node = _document.createNode(CC::PRIMITIVE_TYPE_LONG);
+            node->longValue = value;
+            return node;
+        }
+
+        public: PrimitiveNode* createDouble(double value)
+        {
+            PrimitiveNode* node = _document.createNode(CC::PRIMITIVE_TYPE_DOUBLE);
+            node->doubleValue = value;
+            return node;
+        }
+
+        public: PrimitiveNode* createBool(bool value)
+        {
+            PrimitiveNode* node = _document.createNode(CC::PRIMITIVE_TYPE_BOOLEAN);
+            node->boolValue = value;
+            return node;
+        }
+
+        public: PrimitiveNode* createNull()
+        {
+            return _document.createNode(CC::PRIMITIVE_TYPE_NULL);
+        }
+
+        public: void add(PrimitiveNode*&, PrimitiveKey* key, PrimitiveNode* value)
+        {
+            PrimitiveMember member;
+            member.key = key;
+            member.value = value;
+            _members.push_back(member);
+        }
+
+        public: void add(PrimitiveNode*&, PrimitiveNode* value)
+        {
+            _elements.push_back(value);
+        }
+
+        public: void finish(PrimitiveNode*& container)
+        {
+            int32 start = container->capacity;
+            if ( CC::PRIMITIVE_TYPE_OBJECT == container->type )
+            {
+                int32 count = (int32)_members.size() - start;
+                container->capacity = count;
+                if ( count > 0 )
+                {
+                    // putMember() keeps the last of duplicate keys and never grows the block.
+                    container->members = _document._arena.allocateArray< PrimitiveMember >(count);
+                    for ( int32 i = 0 ; i < count ; ++i )
+                    {
+                        _document.putMember(container, _members[start + i].key, _members[start + i].value);
+                    }
+                }
+                _members.resize(start);
+            }
+            else
+            {
+                int32 count = (int32)_elements.size() - start;
+                container->capacity = count;
+                container->size = count;
+                if ( count > 0 )
+                {
+                    container->elements = _document._arena.allocateArray< PrimitiveNode* >(count);
+                    memcpy(container->elements, &_elements[start], count * sizeof(PrimitiveNode*));
+                    for ( int32 i = 0 ; i < count ; ++i )
+                    {
+                        container->elements[i]->parent = container;
+                    }
+                }
+                _elements.resize(start);
+            }
+        }
+    };
+};
+
+/**
+ * IPrimitive implementation referring to a node of PrimitiveDocument.
+ *
+ * Handles are lightweight (allocated from ObjectPool) and are created every time a child is accessed,
+ * so two handles to the same node are not the same object. They compare as equal with equals(), though.
+ */
+/*O*public**/ class DocumentPrimitive : public Common< IPrimitive >/*C*/, public Pooled< DocumentPrimitive >/**/
+{
+    private: O< PrimitiveDocument > _document;
+
+    private: PrimitiveNode* _node;
+
+    public: DocumentPrimitive(const O< PrimitiveDocument >& document, PrimitiveNode* node)
+        : _document(document)
+        , _node(node)
+    {
+    }
+
+    /**
+     * Returns handle to node or NULL if node is NULL.
+     */
+    public: static GPrimitive wrap(const O< PrimitiveDocument >& document, PrimitiveNode* node)
+    {
+        return ( NULL != node ) ? GPrimitive(new DocumentPrimitive(document, node)) : GPrimitive();
+    }
+
+    public: const O< PrimitiveDocument >& getDocument() const
+    {
+        return _document;
+    }
+
+    public: PrimitiveNode* getNode() const
+    {
+        return _node;
+    }
+
+    /**
+     * @name ICommon section
+     */
+
+    public: virtual int32 hashCode()
+    {
+        return Common< IPrimitive >::hashCode((int64)(size_t)_node);
+    }
+
+    /**
+     * Returns true if o refers to the same node.
+     */
+    public: virtual bool equals(const GCommonObj& o)
+    {
+        DocumentPrimitive* other = dynamic_cast< DocumentPrimitive* >(o.get());
+        return ( NULL != other ) && ( other->_node == _node );
+    }
+
+    /**
+     * Returns JSON representation of the subtree.
+     */
+    public: virtual GString toString()
+    {
+        JsonBufferSink sink;
+        {
+            JsonWriter writer(sink);
+            writer.value(GPrimitive(Object::fromThis(this)));
+        }
+        return sink.toString();
+    }
+
+    /**
+     * @name IComparable section
+     */
+
+    public: virtual bool isEqual(const GCommon& o)
+    {
+        IPrimitive* other = dynamic_cast< IPrimitive* >(o.get());
+        if ( NULL == other )
+        {
+            return false;
+        }
+        DocumentPrimitive* handle = dynamic_cast< DocumentPrimitive* >(other);
+        if ( NULL == handle )
+        {
+            return _document->equals(_node, other);
+        }
+        // Hashes are cached, so comparing the same documents again is decided in constant time unless they
+        // are equal.
+        return ( PrimitiveDocument::contentHash(_node) == PrimitiveDocument::contentHash(handle->_node) ) &&
+            PrimitiveDocument::equals(_node, handle->_node);
+    }
+
+    /**
+     * Returns content hash of the subtree (see PrimitiveDocument::contentHash()). Lets owners of documents
+     * detect that a new version did not change anything without comparing trees.
+     */
+    public: unsigned int contentHash()
+    {
+        return PrimitiveDocument::contentHash(_node);
+    }
+
+    /**
+     * @name IPrimitive section
+     */
+
+    public: virtual int32 type()
+    {
+        return _node->type;
+    }
+
+    public: virtual bool isArray()
+    {
+        return CC::PRIMITIVE_TYPE_ARRAY == _node->type;
+    }
+
+    public: virtual bool isObject()
+    {
+        return CC::PRIMITIVE_TYPE_OBJECT == _node->type;
+    }
+
+    public: virtual bool isDouble()
+    {
+        return CC::PRIMITIVE_TYPE_DOUBLE == _node->type;
+    }
+
+    public: virtual bool isLong()
+    {
+        return CC::PRIMITIVE_TYPE_LONG == _node->type;
+    }
+
+    public: virtual bool isBool()
+    {
+        return CC::PRIMITIVE_TYPE_BOOLEAN == _node->type;
+    }
+
+    public: virtual bool isString()
+    {
+        return CC::PRIMITIVE_TYPE_STRING == _node->type;
+    }
+
+    public: virtual bool isNull()
+    {
+        return CC::PRIMITIVE_TYPE_NULL == _node->type;
+    }
+
+    /**
+     * Returns number of elements or members of containers, 0 for other types.
+     */
+    public: virtual int32 size()
+    {
+        return isContainer(_node) ? PrimitiveDocument::expand(_node)->size : 0;
+    }
+
+    /**
+     * Copies the subtree into a new document.
+     */
+    public: virtual GPrimitive clone()
+    {
+        return PrimitiveDocument::copy(GPrimitive(Object::fromThis(this)));
+    }
+
+    public: virtual bool merge(const GPrimitive& from, bool overrideTarget)
+    {
+        if ( from == NULL )
+        {
+            return false;
+        }
+        int32 fromType = from->type();
+        if ( CC::PRIMITIVE_TYPE_ARRAY == _node->type )
+        {
+            if ( CC::PRIMITIVE_TYPE_ARRAY == fromType )
+            {
+                int32 count = from->size();
+                for ( int32 i = 0 ; i < count ; ++i )
+                {
+                    _document->appendElement(_node, copyOf(from->get(i)));
+                }
+            }
+            else
+            {
+                _document->appendElement(_node, copyOf(from));
+            }
+            return true;
+        }
+        if ( ( CC::PRIMITIVE_TYPE_OBJECT == _node->type ) && ( CC::PRIMITIVE_TYPE_OBJECT == fromType ) )
+        {
+            bool merged = true;
+            GEnumeration< GString >::ptr keys = from->getKeys();
+            while ( ( keys != NULL ) && keys->hasMoreElements() )
+            {
+                GString key = keys->nextElement();
+                GPrimitive value = from->get(key);
+                PrimitiveNode* existing = findChild(key);
+                if ( NULL == existing )
+                {
+                    _document->putMember(_node, _document->internKey(key), copyOf(value));
+                }
+                else if ( !wrap(_document, existing)->merge(value, overrideTarget) )
+                {
+                    merged = false;
+                }
+            }
+            return merged;
+        }
+        if ( ( _node->type == fromType ) || overrideTarget )
+        {
+            PrimitiveDocument::assign(_node, copyOf(from));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Value getters. Longs and doubles are converted into each other.
+     */
+
+    public: virtual double getDouble()
+    {
+        return PrimitiveDocument::toDouble(_node);
+    }
+
+    public: virtual int64 getLong()
+    {
+        return PrimitiveDocument::toLong(_node);
+    }
+
+    public: virtual bool getBool()
+    {
+        return PrimitiveDocument::toBool(_node);
+    }
+
+    public: virtual GString getString()
+    {
+        return _document->getString(_node);
+    }
+
+    /**
+     * Object getters.
+     */
+
+    public: virtual GPrimitive get(const GString& key)
+    {
+        return wrap(_document, findChild(key));
+    }
+
+    public: virtual double getDouble(const GString& key)
+    {
+        PrimitiveNode* child = findChild(key);
+        return ( NULL != child ) ? PrimitiveDocument::toDouble(child) : 0;
+    }
+
+    public: virtual int64 getLong(const GString& key)
+    {
+        PrimitiveNode* child = findChild(key);
+        return ( NULL != child ) ? PrimitiveDocument::toLong(child) : 0;
+    }
+
+    public: virtual bool getBool(const GString& key)
+    {
+        PrimitiveNode* child = findChild(key);
+        return ( NULL != child ) && PrimitiveDocument::toBool(child);
+    }
+
+    public: virtual GString getString(const GString& key)
+    {
+        PrimitiveNode* child = findChild(key);
+        return ( NULL != child ) ? _document->getString(child) : GString();
+    }
+
+    public: virtual GEnumeration< GString >::ptr getKeys()
+    {
+        if ( CC::PRIMITIVE_TYPE_OBJECT != _node->type )
+        {
+            return NULL;
+        }
+        PrimitiveDocument::expand(_node);
+        KeyEnumeration* keys = new KeyEnumeration(_document);
+        keys->_keys.reserve(_node->size);
+        for ( int32 i = 0 ; i < _node->size ; ++i )
+        {
+            keys->_keys.push_back(_node->members[i].key);
+        }
+        return keys;
+    }
+
+    public: virtual bool hasKey(const GString& key)
+    {
+        return NULL != findChild(key);
+    }
+
+    /**
+     * Array getters.
+     */
+
+    /**
+     * Returns live view of array elements or NULL if this is not an array.
+     */
+    public: virtual GArray< GPrimitive >::ptr getArray()
+    {
+        return ( CC::PRIMITIVE_TYPE_ARRAY == _node->type ) ? new Elements(_document, _node) : NULL;
+    }
+
+    public: virtual GPrimitive get(int32 index)
+    {
+        return wrap(_document, findChild(index));
+    }
+
+    public: virtual double getDouble(int32 index)
+    {
+        PrimitiveNode* child = findChild(index);
+        return ( NULL != child ) ? PrimitiveDocument::toDouble(child) : 0;
+    }
+
+    public: virtual int64 getLong(int32 index)
+    {
+        PrimitiveNode* child = findChild(index);
+        return ( NULL != child ) ? PrimitiveDocument::toLong(child) : 0;
+    }
+
+    public: virtual bool getBool(int32 index)
+    {
+        PrimitiveNode* child = findChild(index);
+        return ( NULL != child ) && PrimitiveDocument::toBool(child);
+    }
+
+    public: virtual GString getString(int32 index)
+    {
+        PrimitiveNode* child = findChild(index);
+        return ( NULL != child ) ? _document->getString(child) : GString();
+    }
+
+    /**
+     * Value modifiers.
+     */
+
+    public: virtual void set(double value)
+    {
+        PrimitiveDocument::reset(_node, CC::PRIMITIVE_TYPE_DOUBLE);
+        _node->doubleValue = value;
+    }
+
+    public: virtual void set(int64 value)
+    {
+        PrimitiveDocument::reset(_node, CC::PRIMITIVE_TYPE_LONG);
+        _node->longValue = value;
+    }
+
+    public: virtual void set(bool value)
+    {
+        PrimitiveDocument::reset(_node, CC::PRIMITIVE_TYPE_BOOLEAN);
+        _node->boolValue = value;
+    }
+
+    public: virtual void set(const GString& value)
+    {
+        _document->setString(_node, value);
+    }
+
+    public: virtual void setNull()
+    {
+        PrimitiveDocument::reset(_node, CC::PRIMITIVE_TYPE_NULL);
+    }
+
+    public: virtual void setArray()
+    {
+        PrimitiveDocument::reset(_node, CC::PRIMITIVE_TYPE_ARRAY);
+    }
+
+    public: virtual void setObject()
+    {
+        PrimitiveDocument::reset(_node, CC::PRIMITIVE_TYPE_OBJECT);
+    }
+
+    /**
+     * Object modifiers. Values are copied unless they belong to the same document.
+     */
+
+    public: virtual void put(const GString& key, const GPrimitive& value)
+    {
+        putChild(key, _document->import(value));
+    }
+
+    public: virtual void put(const GString& key, double value)
+    {
+        putChild(key, createDouble(value));
+    }
+
+    public: virtual void put(const GString& key, int64 value)
+    {
+        putChild(key, createLong(value));
+    }
+
+    public: virtual void put(const GString& key, bool value)
+    {
+        putChild(key, createBool(value));
+    }
+
+    public: virtual void put(const GString& key, const GString& value)
+    {
+        putChild(key, createString(value));
+    }
+
+    public: virtual void putNull(const GString& key)
+    {
+        putChild(key, _document->createNode(CC::PRIMITIVE_TYPE_NULL));
+    }
+
+    public: virtual void remove(const GString& key)
+    {
+        int32 index = findMember(key);
+        if ( index >= 0 )
+        {
+            _document->removeMember(_node, index);
+        }
+    }
+
+    /**
+     * Array modifiers. Values are copied unless they belong to the same document.
+     */
+
+    public: virtual void put(const GPrimitive& value)
+    {
+        appendChild(_document->import(value));
+    }
+
+    public: virtual void put(double value)
+    {
+        appendChild(createDouble(value));
+    }
+
+    public: virtual void put(int64 value)
+    {
+        appendChild(createLong(value));
+    }
+
+    public: virtual void put(bool value)
+    {
+        appendChild(createBool(value));
+    }
+
+    public: virtual void put(const GString& value)
+    {
+        appendChild(createString(value));
+    }
+
+    /**
+     * Inserts value at index. Indexes past the end append the value.
+     */
+    public: virtual void insert(int32 index, const GPrimitive& value)
+    {
+        if ( ( CC::PRIMITIVE_TYPE_ARRAY == _node->type ) && ( index >= 0 ) )
+        {
+            PrimitiveDocument::expand(_node);
+            _document->insertElement(_node, ( index < _node->size ) ? index : _node->size, _document->import(value));
+        }
+    }
+
+    public: virtual void put(int32 index, const GPrimitive& value)
+    {
+        replaceChild(index, _document->import(value));
+    }
+
+    public: virtual void put(int32 index, double value)
+    {
+        replaceChild(index, createDouble(value));
+    }
+
+    public: virtual void put(int32 index, int64 value)
+    {
+        replaceChild(index, createLong(value));
+    }
+
+    public: virtual void put(int32 index, bool value)
+    {
+        replaceChild(index, createBool(value));
+    }
+
+    public: virtual void put(int32 index, const GString& value)
+    {
+        replaceChild(index, createString(value));
+    }
+
+    public: virtual void putNull(int32 index)
+    {
+        replaceChild(index, _document->createNode(CC::PRIMITIVE_TYPE_NULL));
+    }
+
+    public: virtual void remove(int32 index)
+    {
+        if ( NULL != findChild(index) )
+        {
+            PrimitiveDocument::removeElement(_node, index);
+        }
+    }
+
+    /**
+     * Removes the first element referring to the same node as value or equal to it.
+     */
+    public: virtual void remove(const GPrimitive& value)
+    {
+        if ( ( CC::PRIMITIVE_TYPE_ARRAY != _node->type ) || ( value == NULL ) )
+        {
+            return;
+        }
+        DocumentPrimitive* handle = dynamic_cast< DocumentPrimitive* >(value.get());
+        PrimitiveDocument::expand(_node);
+        for ( int32 i = 0 ; i < _node->size ; ++i )
+        {
+            PrimitiveNode* element = _node->elements[i];
+            if ( ( NULL != handle ) ? PrimitiveDocument::equals(element, handle->_node) : _document->equals(element, value.get()) )
+            {
+                PrimitiveDocument::removeElement(_node, i);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static inline bool isContainer(const PrimitiveNode* node)
+    {
+        return ( CC::PRIMITIVE_TYPE_OBJECT == node->type ) || ( CC::PRIMITIVE_TYPE_ARRAY == node->type );
+    }
+
+    /**
+     * Returns index of member with the specified name or -1.
+     */
+    private: int32 findMember(const GString& key)
+    {
+        if ( ( CC::PRIMITIVE_TYPE_OBJECT != _node->type ) || ( key == NULL ) )
+        {
+            return -1;
+        }
+        // Keys of deferred objects are not known to the document yet.
+        PrimitiveDocument::expand(_node);
+        PrimitiveKey* documentKey = _document->findKey(key->getBytes(), key->length());
+        return ( NULL != documentKey ) ? PrimitiveDocument::findMember(_node, documentKey) : -1;
+    }
+
+    private: PrimitiveNode* findChild(const GString& key)
+    {
+        int32 index = findMember(key);
+        return ( index >= 0 ) ? _node->members[index].value : NULL;
+    }
+
+    private: PrimitiveNode* findChild(int32 index)
+    {
+        return ( ( CC::PRIMITIVE_TYPE_ARRAY == _node->type ) && ( index >= 0 ) &&
+            ( index < PrimitiveDocument::expand(_node)->size ) ) ? _node->elements[index] : NULL;
+    }
+
+    private: void putChild(const GString& key, PrimitiveNode* value)
+    {
+        if ( ( CC::PRIMITIVE_TYPE_OBJECT == _node->type ) && ( key != NULL ) )
+        {
+            _document->putMember(_node, _document->internKey(key), value);
+        }
+    }
+
+    private: void appendChild(PrimitiveNode* value)
+    {
+        if ( CC::PRIMITIVE_TYPE_ARRAY == _node->type )
+        {
+            _document->appendElement(_node, value);
+        }
+    }
+
+    private: void replaceChild(int32 index, PrimitiveNode* value)
+    {
+        if ( NULL != findChild(index) )
+        {
+            PrimitiveDocument::replaceElement(_node, index, value);
+        }
+    }
+
+    /**
+     * Returns node holding a copy of value, even if it belongs to this document.
+     */
+    private: PrimitiveNode* copyOf(const GPrimitive& value)
+    {
+        DocumentPrimitive* handle = dynamic_cast< DocumentPrimitive* >(value.get());
+        return ( NULL != handle ) ? _document->copyNode(*handle->_document.get(), handle->_node) : _document->import(value);
+    }
+
+    private: PrimitiveNode* createDouble(double value)
+    {
+        PrimitiveNode* node = _document->createNode(CC::PRIMITIVE_TYPE_DOUBLE);
+        node->doubleValue = value;
+        return node;
+    }
+
+    private: PrimitiveNode* createLong(int64 value)
+    {
+        PrimitiveNode* node = _document->createNode(CC::PRIMITIVE_TYPE_LONG);
+        node->longValue = value;
+        return node;
+    }
+
+    private: PrimitiveNode* createBool(bool value)
+    {
+        PrimitiveNode* node = _document->createNode(CC::PRIMITIVE_TYPE_BOOLEAN);
+        node->boolValue = value;
+        return node;
+    }
+
+    private: PrimitiveNode* createString(const GString& value)
+    {
+        PrimitiveNode* node = _document->createNode(CC::PRIMITIVE_TYPE_NULL);
+        _document->setString(node, value);
+        return node;
+    }
+
+    /**
+     * Enumerates snapshot of the keys, so that the object can be modified during enumeration.
+     */
+    private: class KeyEnumeration : public Common< IEnumeration< GString > >
+    {
+        public: std::vector< PrimitiveKey* > _keys;
+
+        private: O< PrimitiveDocument > _document;
+
+        private: int32 _position;
+
+        public: explicit KeyEnumeration(const O< PrimitiveDocument >& document)
+            : _document(document)
+            , _position(0)
+        {
+        }
+
+        public: virtual bool hasMoreElements()
+        {
+            return _position < (int32)_keys.size();
+        }
+
+        public: virtual GString nextElement()
+        {
+            return _document->getKeyString(_keys[_position++]);
+        }
+    };
+
+    /**
+     * Live view of array elements.
+     */
+    private: class Elements : public Common< IArray< GPrimitive > >
+    {
+        private: O< PrimitiveDocument > _document;
+
+        private: PrimitiveNode* _node;
+
+        public: Elements(const O< PrimitiveDocument >& document, PrimitiveNode* node)
+            : _document(document)
+            , _node(node)
+        {
+        }
+
+        public: virtual int32 length()
+        {
+            return ( CC::PRIMITIVE_TYPE_ARRAY == _node->type ) ? PrimitiveDocument::expand(_node)->size : 0;
+        }
+
+        public: virtual GPrimitive at(int32 index)
+        {
+            return ( ( index >= 0 ) && ( index < length() ) ) ? wrap(_document, _node->elements[index]) : GPrimitive();
+        }
+
+        public: virtual GEnumeration< GPrimitive >::ptr elements()
+        {
+            return new ElementEnumeration(GArray< GPrimitive >::ptr(Object::fromThis(this)));
+        }
+
+        /**
+         * Returns view of a new array node holding copies of the elements.
+         */
+        public: virtual GArray< GPrimitive >::ptr clone()
+        {
+            PrimitiveNode* copy = _document->createNode(CC::PRIMITIVE_TYPE_ARRAY);
+            for ( int32 i = 0, count = length() ; i < count ; ++i )
+            {
+                _document->appendElement(copy, _document->copyNode(*_document.get(), _node->elements[i]));
+            }
+            return new Elements(_document, copy);
+        }
+    };
+
+    private: class ElementEnumeration : public Common< IEnumeration< GPrimitive > >
+    {
+        private: GArray< GPrimitive >::ptr _array;
+
+        private: int32 _position;
+
+        public: explicit ElementEnumeration(const GArray< GPrimitive >::ptr& array)
+            : _array(array)
+            , _position(0)
+        {
+        }
+
+        public: virtual bool hasMoreElements()
+        {
+            return _position < _array->length();
+        }
+
+        public: virtual GPrimitive nextElement()
+        {
+            return _array->at(_position++);
+        }
+    };
+};
+
+/**
+ * @name PrimitiveDocument members depending on DocumentPrimitive
+ */
+
+inline GPrimitive PrimitiveDocument::parse(const char* json, int32 length)
+{
+    O< PrimitiveDocument > document(new PrimitiveDocument(length));
+    DocumentBuilder builder(*document.get());
+    PrimitiveNode* root = NULL;
+    return JsonParser::parse(json, length, builder, root) ? DocumentPrimitive::wrap(document, root) : GPrimitive();
+}
+
+inline GPrimitive PrimitiveDocument::parseLazy(const char* json, int32 length)
+{
+    O< PrimitiveDocument > document(new PrimitiveDocument(Arena::MIN_CHUNK_SIZE));
+    document->_source = document->_arena.copy(json, length);
+    document->_sourceLength = length;
+    DocumentBuilder builder(*document.get());
+    PrimitiveNode* root = NULL;
+    return JsonParser::parse(document->_source, length, builder, root, document->_index)
+        ? DocumentPrimitive::wrap(document, root) : GPrimitive();
+}
+
+inline GPrimitive PrimitiveDocument::parseLazy(const GString& json)
+{
+    if ( json == NULL )
+    {
+        return NULL;
+    }
+    O< PrimitiveDocument > document(new PrimitiveDocument(Arena::MIN_CHUNK_SIZE));
+    document->_sourceString = json;
+    document->_source = json->getBytes();
+    document->_sourceLength = json->length();
+    DocumentBuilder builder(*document.get());
+    PrimitiveNode* root = NULL;
+    return JsonParser::parse(document->_source, document->_sourceLength, builder, root, document->_index)
+        ? DocumentPrimitive::wrap(document, root) : GPrimitive();
+}
+
+inline GPrimitive PrimitiveDocument::create(int32 type)
+{
+    O< PrimitiveDocument > document(new PrimitiveDocument(Arena::MIN_CHUNK_SIZE));
+    return DocumentPrimitive::wrap(document, document->createNode(type));
+}
+
+inline GPrimitive PrimitiveDocument::copy(const GPrimitive& source)
+{
+    if ( source == NULL )
+    {
+        return NULL;
+    }
+    O< PrimitiveDocument > document(new PrimitiveDocument(Arena::MIN_CHUNK_SIZE));
+    DocumentPrimitive* handle = dynamic_cast< DocumentPrimitive* >(source.get());
+    PrimitiveNode* root = ( NULL != handle ) ? document->copyNode(*handle->getDocument().get(), handle->getNode())
+        : document->import(source);
+    return DocumentPrimitive::wrap(document, root);
+}
+
+inline unsigned int PrimitiveDocument::contentHash(IPrimitive* value)
+{
+    DocumentPrimitive* handle = dynamic_cast< DocumentPrimitive* >(value);
+    if ( NULL != handle )
+    {
+        return contentHash(handle->getNode());
+    }
+    int32 type = value->type();
+    int32 size = 0;
+    unsigned int content = 0;
+    switch ( type )
+    {
+        case CC::PRIMITIVE_TYPE_OBJECT:
+        {
+            GEnumeration< GString >::ptr keys = value->getKeys();
+            while ( ( keys != NULL ) && keys->hasMoreElements() )
+            {
+                GString key = keys->nextElement();
+                GPrimitive member = value->get(key);
+                content += hashMember(JsonParser::hashKey(key->getBytes(), key->length()), contentHash(member.get()));
+                ++size;
+            }
+            break;
+        }
+        case CC::PRIMITIVE_TYPE_ARRAY:
+        {
+            size = value->size();
+            for ( int32 i = 0 ; i < size ; ++i )
+            {
+                content = hashElement(content, contentHash(value->get(i).get()));
+            }
+            break;
+        }
+        case CC::PRIMITIVE_TYPE_STRING:
+        {
+            GString string = value->getString();
+            size = string->length();
+            content = JsonParser::hashKey(string->getBytes(), size);
+            break;
+        }
+        case CC::PRIMITIVE_TYPE_DOUBLE:
+            content = hashDouble(value->getDouble());
+            break;
+        case CC::PRIMITIVE_TYPE_LONG:
+            content = hashLong(value->getLong());
+            break;
+        case CC::PRIMITIVE_TYPE_BOOLEAN:
+            content = value->getBool() ? 1 : 0;
+            break;
+        default:
+            break;
+    }
+    return hashValue(type, size, content);
+}
+
+inline PrimitiveNode* PrimitiveDocument::import(const GPrimitive& value)
+{
+    if ( value == NULL )
+    {
+        return createNode(CC::PRIMITIVE_TYPE_NULL);
+    }
+    DocumentPrimitive* handle = dynamic_cast< DocumentPrimitive* >(value.get());
+    if ( NULL != handle )
+    {
+        PrimitiveNode* node = handle->getNode();
+        return ( ( handle->getDocument().get() == this ) && ( NULL == node->parent ) ) ? node
+            : copyNode(*handle->getDocument().get(), node);
+    }
+    int32 type = value->type();
+    PrimitiveNode* node = createNode(type);
+    switch ( type )
+    {
+        case CC::PRIMITIVE_TYPE_OBJECT:
+        {
+            GEnumeration< GString >::ptr keys = value->getKeys();
+            while ( ( keys != NULL ) && keys->hasMoreElements() )
+            {
+                GString key = keys->nextElement();
+                putMember(node, internKey(key), import(value->get(key)));
+            }
+            break;
+        }
+        case CC::PRIMITIVE_TYPE_ARRAY:
+        {
+            int32 size = value->size();
+            for ( int32 i = 0 ; i < size ; ++i )
+            {
+                appendElement(node, import(value->get(i)));
+            }
+            break;
+        }
+        case CC::PRIMITIVE_TYPE_DOUBLE:
+            node->doubleValue = value->getDouble();
+            break;
+        case CC::PRIMITIVE_TYPE_LONG:
+            node->longValue = value->getLong();
+            break;
+        case CC::PRIMITIVE_TYPE_BOOLEAN:
+            node->boolValue = value->getBool();
+            break;
+        case CC::PRIMITIVE_TYPE_STRING:
+            setString(node, value->getString());
+            break;
+        default:
+            break;
+    }
+    return node;
+}
+
+}
+
+#endif // !PRIMITIVEDOCUMENT_H__GLYMPSE__
@@ -0,0 +1,596 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef PRIMITIVEPATCH_H__GLYMPSE__
+#define PRIMITIVEPATCH_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Structural difference of primitive trees in JSON Patch format (RFC 6902).
+ *
+ * A patch is an array of operation objects such as {"op":"replace","path":"/speed","value":12}.
+ * Paths are JSON Pointers (see PrimitivePath). diff() produces add, remove and replace operations;
+ * apply() also understands move, copy and test.
+ *
+ *     GPrimitive patch = PrimitivePatch::diff(saved, current);
+ *     if ( patch->size() > 0 )
+ *     {
+ *         // Send or store the patch instead of the whole document.
+ *     }
+ *
+ * Patches are regular primitives, so they are written with JsonWriter, or with PrimitiveCodec to get
+ * a compact binary form. Works with primitives of any implementation.
+ */
+class PrimitivePatch
+{
+    /**
+     * @name Operation Members
+     */
+
+    public: static GString OP()
+    {
+        return CoreFactory::internString("op");
+    }
+
+    public: static GString PATH()
+    {
+        return CoreFactory::internString("path");
+    }
+
+    public: static GString FROM()
+    {
+        return CoreFactory::internString("from");
+    }
+
+    public: static GString VALUE()
+    {
+        return CoreFactory::internString("value");
+    }
+
+    /**
+     * @name Operations
+     */
+
+    public: static GString ADD()
+    {
+        return CoreFactory::internString("add");
+    }
+
+    public: static GString REMOVE()
+    {
+        return CoreFactory::internString("remove");
+    }
+
+    public: static GString REPLACE()
+    {
+        return CoreFactory::internString("replace");
+    }
+
+    public: static GString MOVE()
+    {
+        return CoreFactory::internString("move");
+    }
+
+    public: static GString COPY()
+    {
+        return CoreFactory::internString("copy");
+    }
+
+    public: static GString TEST()
+    {
+        return CoreFactory::internString("test");
+    }
+
+    /**
+     * @name Diff and Apply
+     */
+
+    /**
+     * Returns patch turning from into to. The patch is empty if the trees are equal.
+     *
+     * Members of objects are compared by name. Arrays are compared element by element after dropping
+     * the common head and tail, so insertions and removals at either end yield a single operation each.
+     *
+     * Values in the patch refer to subtrees of to instead of copying them. Clone the patch before
+     * modifying to if it is kept.
+     */
+    public: static GPrimitive diff(const GPrimitive& from, const GPrimitive& to)
+    {
+        GPrimitive patch = CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_ARRAY);
+        StringBuilder path;
+        diff(from, to, path, patch);
+        return patch;
+    }
+
+    /**
+     * Applies patch to target. Operations on the root replace target itself.
+     *
+     * Values are copied from the patch, so it can be applied again. Returns false if the patch is
+     * malformed, an operation refers to a missing location or a test fails. Operations preceding the
+     * failed one stay applied; apply the patch to a clone if that is not acceptable.
+     */
+    public: static bool apply(GPrimitive& target, const GPrimitive& patch)
+    {
+        if ( ( patch == NULL ) || !patch->isArray() )
+        {
+            return false;
+        }
+        int32 count = patch->size();
+        for ( int32 i = 0 ; i < count ; ++i )
+        {
+            if ( !applyOperation(target, patch->get(i)) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Returns true if the patch changes the value at pointer: the value itself, anything nested in it
+     * or any of its ancestors. Lets listeners skip work when the part they watch is not affected.
+     *
+     * Adding or removing an array element shifts the elements following it, so such operations affect
+     * every pointer through an element at the same or a higher index of the same array. Numeric segments
+     * are assumed to address array elements, so the answer errs on the side of true for objects with
+     * numeric member names, and for appends ("/items/-"), which might fill the watched index.
+     */
+    public: static bool affects(const GPrimitive& patch, const StringView& pointer)
+    {
+        if ( ( patch == NULL ) || !patch->isArray() )
+        {
+            return false;
+        }
+        int32 count = patch->size();
+        for ( int32 i = 0 ; i < count ; ++i )
+        {
+            GPrimitive operation = patch->get(i);
+            if ( ( operation == NULL ) || !operation->isObject() )
+            {
+                continue;
+            }
+            GString op = operation->getString(OP());
+            if ( isOperation(op, TEST()) )
+            {
+                continue;
+            }
+            // Operations inserting or removing a value shift following array elements.
+            bool shifts = !isOperation(op, REPLACE());
+            GString path = operation->getString(PATH());
+            if ( ( path != NULL ) && isAffected(StringView(path), shifts, pointer) )
+            {
+                return true;
+            }
+            GString from = operation->getString(FROM());
+            if ( isOperation(op, MOVE()) && ( from != NULL ) && isAffected(StringView(from), true, pointer) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static void diff(const GPrimitive& from, const GPrimitive& to, StringBuilder& path, const GPrimitive& patch)
+    {
+        if ( from.get() == to.get() )
+        {
+            return;
+        }
+        if ( from == NULL )
+        {
+            addOperation(patch, ADD(), path, to);
+            return;
+        }
+        if ( to == NULL )
+        {
+            addOperation(patch, REMOVE(), path, NULL);
+            return;
+        }
+        int32 type = from->type();
+        if ( type != to->type() )
+        {
+            addOperation(patch, REPLACE(), path, to);
+        }
+        else if ( CC::PRIMITIVE_TYPE_OBJECT == type )
+        {
+            diffObjects(from, to, path, patch);
+        }
+        else if ( CC::PRIMITIVE_TYPE_ARRAY == type )
+        {
+            diffArrays(from, to, path, patch);
+        }
+        else if ( !from->isEqual(to) )
+        {
+            addOperation(patch, REPLACE(), path, to);
+        }
+    }
+
+    private: static void diffObjects(const GPrimitive& from, const GPrimitive& to, StringBuilder& path,
+        const GPrimitive& patch)
+    {
+        int32 length = path.length();
+        GEnumeration< GString >::ptr keys = from->getKeys();
+        while ( ( keys != NULL ) && keys->hasMoreElements() )
+        {
+            GString key = keys->nextElement();
+            appendKey(path, key);
+            GPrimitive value = to->get(key);
+            if ( value == NULL )
+            {
+                addOperation(patch, REMOVE(), path, NULL);
+            }
+            else
+            {
+                diff(from->get(key), value, path, patch);
+            }
+            path.setLength(length);
+        }
+        keys = to->getKeys();
+        while ( ( keys != NULL ) && keys->hasMoreElements() )
+        {
+            GString key = keys->nextElement();
+            if ( !from->hasKey(key) )
+            {
+                appendKey(path, key);
+                addOperation(patch, ADD(), path, to->get(key));
+                path.setLength(length);
+            }
+        }
+    }
+
+    private: static void diffArrays(const GPrimitive& from, const GPrimitive& to, StringBuilder& path,
+        const GPrimitive& patch)
+    {
+        int32 fromSize = from->size();
+        int32 toSize = to->size();
+        int32 shorter = ( fromSize < toSize ) ? fromSize : toSize;
+        int32 head = 0;
+        while ( ( head < shorter ) && isEqual(from->get(head), to->get(head)) )
+        {
+            ++head;
+        }
+        int32 tail = 0;
+        while ( ( tail < shorter - head ) && isEqual(from->get(fromSize - 1 - tail), to->get(toSize - 1 - tail)) )
+        {
+            ++tail;
+        }
+
+        // Elements between head and tail: pair them up, then remove or add the rest.
+        int32 fromCount = fromSize - head - tail;
+        int32 toCount = toSize - head - tail;
+        int32 common = ( fromCount < toCount ) ? fromCount : toCount;
+        int32 length = path.length();
+        for ( int32 i = 0 ; i < common ; ++i )
+        {
+            path.append('/').append(head + i);
+            diff(from->get(head + i), to->get(head + i), path, patch);
+            path.setLength(length);
+        }
+        // Removing from the back keeps indexes of the remaining elements valid.
+        for ( int32 i = fromCount - 1 ; i >= common ; --i )
+        {
+            path.append('/').append(head + i);
+            addOperation(patch, REMOVE(), path, NULL);
+            path.setLength(length);
+        }
+        for ( int32 i = common ; i < toCount ; ++i )
+        {
+            path.append('/').append(head + i);
+            addOperation(patch, ADD(), path, to->get(head + i));
+            path.setLength(length);
+        }
+    }
+
+    private: static bool isEqual(const GPrimitive& lhs, const GPrimitive& rhs)
+    {
+        return ( lhs.get() == rhs.get() ) || ( ( lhs != NULL ) && lhs->isEqual(rhs) );
+    }
+
+    /**
+     * Appends reference token for key, escaping '~' and '/'.
+     */
+    private: static void appendKey(StringBuilder& path, const GString& key)
+    {
+        path.append('/');
+        const char* chars = key->getBytes();
+        for ( int32 i = 0, length = key->length() ; i < length ; ++i )
+        {
+            switch ( chars[i] )
+            {
+                case '~':
+                    path.append("~0", 2);
+                    break;
+                case '/':
+                    path.append("~1", 2);
+                    break;
+                default:
+                    path.append(chars[i]);
+                    break;
+            }
+        }
+    }
+
+    private: static void addOperation(const GPrimitive& patch, const GString& op, const StringBuilder& path,
+        const GPrimitive& value)
+    {
+        GPrimitive operation = CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_OBJECT);
+        operation->put(OP(), op);
+        operation->put(PATH(), path.toString());
+        if ( value != NULL )
+        {
+            operation->put(VALUE(), value);
+        }
+        patch->put(operation);
+    }
+
+    private: static bool isOperation(const GString& op, const GString& name)
+    {
+        return ( op != NULL ) && StringView(op).equals(StringView(name));
+    }
+
+    /**
+     * Returns true if one of the pointers refers to the other or to a location nested in it.
+     */
+    private: static bool isRelated(const StringView& lhs, const StringView& rhs)
+    {
+        const StringView& shorter = ( lhs.length() < rhs.length() ) ? lhs : rhs;
+        const StringView& longer = ( lhs.length() < rhs.length() ) ? rhs : lhs;
+        return longer.startsWith(shorter) &&
+            ( ( longer.length() == shorter.length() ) || ( '/' == longer.charAt(shorter.length()) ) );
+    }
+
+    /**
+     * Returns true if changing the value at path affects the value at pointer. If shifts is set, the change
+     * inserts or removes the value at path, which moves following elements of an array.
+     */
+    private: static bool isAffected(const StringView& path, bool shifts, const StringView& pointer)
+    {
+        if ( isRelated(path, pointer) )
+        {
+            return true;
+        }
+        int32 slash = path.lastIndexOf('/');
+        if ( !shifts || ( slash < 0 ) || ( pointer.length() <= slash ) || ( '/' != pointer.charAt(slash) ) ||
+            !pointer.startsWith(path.substring(0, slash)) )
+        {
+            return false;
+        }
+        // Both pointers go through the same container. Compare the positions within it.
+        StringView token = path.substring(slash + 1);
+        int32 end = pointer.indexOf('/', slash + 1);
+        int32 watched = parseIndex(pointer.substring(slash + 1, ( end < 0 ) ? pointer.length() : end));
+        if ( watched < 0 )
+        {
+            return false;
+        }
+        if ( token.equals("-") )
+        {
+            return true;
+        }
+        int32 index = parseIndex(token);
+        return ( index >= 0 ) && ( index <= watched );
+    }
+
+    /**
+     * Returns array index denoted by reference token, or -1 if the token is not a number.
+     * Indexes too large to fit are capped, which keeps them comparable.
+     */
+    private: static int32 parseIndex(const StringView& token)
+    {
+        if ( token.isEmpty() )
+        {
+            return -1;
+        }
+        int64 index = 0;
+        for ( int32 i = 0 ; i < token.length() ; ++i )
+        {
+            char ch = token.charAt(i);
+            if ( ( ch < '0' ) || ( ch > '9' ) )
+            {
+                return -1;
+            }
+            if ( index < 0x7fffffff )
+            {
+                index = index * 10 + ( ch - '0' );
+            }
+        }
+        return ( index < 0x7fffffff ) ? (int32)index : 0x7fffffff;
+    }
+
+    private: static bool applyOperation(GPrimitive& target, const GPrimitive& operation)
+    {
+        if ( ( operation == NULL ) || !operation->isObject() )
+        {
+            return false;
+        }
+        GString op = operation->getString(OP());
+        GString pointer = operation->getString(PATH());
+        if ( pointer == NULL )
+        {
+            return false;
+        }
+        PrimitivePath path = PrimitivePath::compile(StringView(pointer));
+        if ( !path.isValid() )
+        {
+            return false;
+        }
+
+        if ( isOperation(op, ADD()) || isOperation(op, REPLACE()) || isOperation(op, TEST()) )
+        {
+            GPrimitive value = operation->get(VALUE());
+            if ( value == NULL )
+            {
+                return false;
+            }
+            if ( isOperation(op, TEST()) )
+            {
+                return isEqual(path.evaluate(target), value);
+            }
+            return isOperation(op, ADD()) ? add(target, path, value, true) : replace(target, path, value);
+        }
+        if ( isOperation(op, REMOVE()) )
+        {
+            return remove(target, path) != NULL;
+        }
+        if ( isOperation(op, MOVE()) || isOperation(op, COPY()) )
+        {
+            GString source = operation->getString(FROM());
+            if ( source == NULL )
+            {
+                return false;
+            }
+            PrimitivePath from = PrimitivePath::compile(StringView(source));
+            if ( !from.isValid() )
+            {
+                return false;
+            }
+            if ( isOperation(op, COPY()) )
+            {
+                GPrimitive value = from.evaluate(target);
+                return ( value != NULL ) && add(target, path, value, true);
+            }
+            // A value cannot be moved into itself.
+            StringView fromView(source);
+            StringView pathView(pointer);
+            if ( ( pathView.length() > fromView.length() ) && isRelated(fromView, pathView) )
+            {
+                return false;
+            }
+            GPrimitive value = remove(target, from);
+            return ( value != NULL ) && add(target, path, value, false);
+        }
+        return false;
+    }
+
+    /**
+     * Returns the container holding the last segment of path or NULL.
+     */
+    private: static GPrimitive parentOf(const GPrimitive& root, const PrimitivePath& path)
+    {
+        GPrimitive value = root;
+        for ( int32 i = 0 ; ( i < path.length() - 1 ) && ( value != NULL ) ; ++i )
+        {
+            value = PrimitivePath::step(value, path._segments[i]);
+        }
+        return value;
+    }
+
+    /**
+     * Returns value to be stored in container. Documents copy values themselves, other containers
+     * would share them with the patch.
+     */
+    private: static GPrimitive detach(const GPrimitive& container, const GPrimitive& value)
+    {
+        return ( NULL != dynamic_cast< DocumentPrimitive* >(container.get()) ) ? value : value->clone();
+    }
+
+    private: static bool add(GPrimitive& target, const PrimitivePath& path, const GPrimitive& value, bool copy)
+    {
+        if ( 0 == path.length() )
+        {
+            target = copy ? value->clone() : value;
+            return true;
+        }
+        GPrimitive parent = parentOf(target, path);
+        if ( parent == NULL )
+        {
+            return false;
+        }
+        const PrimitivePath::Segment& segment = path._segments[path.length() - 1];
+        GPrimitive stored = copy ? detach(parent, value) : value;
+        if ( parent->isObject() )
+        {
+            parent->put(segment.name, stored);
+            return true;
+        }
+        if ( !parent->isArray() )
+        {
+            return false;
+        }
+        int32 size = parent->size();
+        if ( ( ( 1 == segment.key.length ) && ( '-' == segment.key.chars[0] ) ) || ( segment.index == size ) )
+        {
+            parent->put(stored);
+            return true;
+        }
+        if ( ( segment.index >= 0 ) && ( segment.index < size ) )
+        {
+            parent->insert(segment.index, stored);
+            return true;
+        }
+        return false;
+    }
+
+    private: static bool replace(GPrimitive& target, const PrimitivePath& path, const GPrimitive& value)
+    {
+        if ( 0 == path.length() )
+        {
+            target = value->clone();
+            return true;
+        }
+        GPrimitive parent = parentOf(target, path);
+        if ( parent == NULL )
+        {
+            return false;
+        }
+        const PrimitivePath::Segment& segment = path._segments[path.length() - 1];
+        if ( parent->isObject() && parent->hasKey(segment.name) )
+        {
+            parent->put(segment.name, detach(parent, value));
+            return true;
+        }
+        if ( parent->isArray() && ( segment.index >= 0 ) && ( segment.index < parent->size() ) )
+        {
+            parent->put(segment.index, detach(parent, value));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Removes the value at path and returns it, or NULL if there is none.
+     */
+    private: static GPrimitive remove(GPrimitive& target, const PrimitivePath& path)
+    {
+        if ( 0 == path.length() )
+        {
+            GPrimitive removed = target;
+            target = NULL;
+            return removed;
+        }
+        GPrimitive parent = parentOf(target, path);
+        if ( parent == NULL )
+        {
+            return NULL;
+        }
+        const PrimitivePath::Segment& segment = path._segments[path.length() - 1];
+        GPrimitive removed;
+        if ( parent->isObject() )
+        {
+            removed = parent->get(segment.name);
+            if ( removed != NULL )
+            {
+                parent->remove(segment.name);
+            }
+        }
+        else if ( parent->isArray() && ( segment.index >= 0 ) && ( segment.index < parent->size() ) )
+        {
+            removed = parent->get(segment.index);
+            parent->remove(segment.index);
+        }
+        return removed;
+    }
+};
+
+}
+
+#endif // !PRIMITIVEPATCH_H__GLYMPSE__
@@ -0,0 +1,502 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef PRIMITIVEPATH_H__GLYMPSE__
+#define PRIMITIVEPATH_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Precompiled location of a value inside a primitive tree.
+ *
+ * Paths use JSON Pointer syntax (RFC 6901): "/routing_profile/speed", "/agents/0/id". Segments consisting
+ * of digits address array elements (and object members with such names), "~1" and "~0" stand for '/' and '~'.
+ * The empty path refers to the root.
+ *
+ *     static const PrimitivePath SPEED = PrimitivePath::compile("/routing_profile/speed");
+ *     double speed = SPEED.getDouble(config, 0);
+ *
+ * Keys are interned once at compile time, so evaluating a path never creates key strings. On PrimitiveDocument
+ * trees the path walks arena nodes directly and remembers the position of each member it found, so lookups
+ * in objects of the same shape hit on the first probe. The typed getters allocate nothing; evaluate() creates
+ * a single handle for the result when the tree is a document.
+ *
+ * Compiled paths are immutable apart from the position hints, which are updated atomically, so they can be
+ * shared between threads. That does not make the trees they are evaluated on shareable: evaluating a path
+ * on a lazily parsed PrimitiveDocument builds the containers it passes through (see PrimitiveDocument).
+ */
+class PrimitivePath
+{
+    friend class PrimitivePathSet;
+
+    friend class PrimitivePatch;
+
+    private: struct Segment
+    {
+        /**
+         * Interned key, used with IPrimitive::get(const GString&).
+         */
+        GString name;
+
+        /**
+         * Key characters, used with document nodes.
+         */
+        PrimitiveKey key;
+
+        /**
+         * Array index or -1 if the segment is not a number.
+         */
+        int32 index;
+
+        /**
+         * Position of the member found last time.
+         */
+        mutable int32 hint;
+    };
+
+    private: std::vector< Segment > _segments;
+
+    private: bool _valid;
+
+    /**
+     * Creates invalid path. Use compile() to create usable ones.
+     */
+    public: PrimitivePath()
+        : _valid(false)
+    {
+    }
+
+    /**
+     * Compiles JSON Pointer. Returns invalid path (see isValid()) if the syntax is wrong.
+     */
+    public: static PrimitivePath compile(const StringView& pointer)
+    {
+        PrimitivePath path;
+        if ( !pointer.isEmpty() && ( '/' != pointer.charAt(0) ) )
+        {
+            return path;
+        }
+        StringBuilder token;
+        for ( int32 start = 1 ; start <= pointer.length() ; )
+        {
+            int32 end = pointer.indexOf('/', start);
+            end = ( StringView::NPOS == end ) ? pointer.length() : end;
+            token.clear();
+            for ( int32 i = start ; i < end ; ++i )
+            {
+                char ch = pointer.charAt(i);
+                if ( '~' == ch )
+                {
+                    char escaped = ( i + 1 < end ) ? pointer.charAt(++i) : '\0';
+                    if ( ( '0' != escaped ) && ( '1' != escaped ) )
+                    {
+                        return PrimitivePath();
+                    }
+                    ch = ( '0' == escaped ) ? '~' : '/';
+                }
+                token.append(ch);
+            }
+            path.addSegment(token.view());
+            start = end + 1;
+        }
+        path._valid = true;
+        return path;
+    }
+
+    /**
+     * Returns false if the path was not compiled or its syntax was wrong. Invalid paths resolve to nothing.
+     */
+    public: bool isValid() const
+    {
+        return _valid;
+    }
+
+    /**
+     * Returns number of segments.
+     */
+    public: int32 length() const
+    {
+        return (int32)_segments.size();
+    }
+
+    /**
+     * Returns the value the path refers to or NULL if there is none.
+     */
+    public: GPrimitive evaluate(const GPrimitive& root) const
+    {
+        DocumentPrimitive* document = asDocument(root);
+        if ( NULL != document )
+        {
+            return DocumentPrimitive::wrap(document->getDocument(), resolve(document->getNode()));
+        }
+        return resolve(root);
+    }
+
+    /**
+     * Returns true if the path refers to a value (including null).
+     */
+    public: bool exists(const GPrimitive& root) const
+    {
+        DocumentPrimitive* document = asDocument(root);
+        return ( NULL != document ) ? ( NULL != resolve(document->getNode()) ) : ( resolve(root) != NULL );
+    }
+
+    /**
+     * @name Typed Getters
+     *
+     * Return defaultValue if the path does not resolve or the value has a different type.
+     * Longs and doubles are converted into each other.
+     */
+
+    public: int64 getLong(const GPrimitive& root, int64 defaultValue = 0) const
+    {
+        DocumentPrimitive* document = asDocument(root);
+        if ( NULL != document )
+        {
+            PrimitiveNode* node = resolve(document->getNode());
+            return ( ( NULL != node ) && isNumber(node->type) ) ? PrimitiveDocument::toLong(node) : defaultValue;
+        }
+        GPrimitive value = resolve(root);
+        return ( ( value != NULL ) && isNumber(value->type()) ) ? value->getLong() : defaultValue;
+    }
+
+    public: double getDouble(const GPrimitive& root, double defaultValue = 0) const
+    {
+        DocumentPrimitive* document = asDocument(root);
+        if ( NULL != document )
+        {
+            PrimitiveNode* node = resolve(document->getNode());
+            return ( ( NULL != node ) && isNumber(node->type) ) ? PrimitiveDocument::toDouble(node) : defaultValue;
+        }
+        GPrimitive value = resolve(root);
+        return ( ( value != NULL ) && isNumber(value->type()) ) ? value->getDouble() : defaultValue;
+    }
+
+    public: bool getBool(const GPrimitive& root, bool defaultValue = false) const
+    {
+        DocumentPrimitive* document = asDocument(root);
+        if ( NULL != document )
+        {
+            PrimitiveNode* node = resolve(document->getNode());
+            return ( ( NULL != node ) && ( CC::PRIMITIVE_TYPE_BOOLEAN == node->type ) ) ? node->boolValue : defaultValue;
+        }
+        GPrimitive value = resolve(root);
+        return ( ( value != NULL ) && value->isBool() ) ? value->getBool() : defaultValue;
+    }
+
+    /**
+     * Returns string value or NULL. Document strings are created once and cached by the document.
+     */
+    public: GString getString(const GPrimitive& root) const
+    {
+        DocumentPrimitive* document = asDocument(root);
+        if ( NULL != document )
+        {
+            PrimitiveNode* node = resolve(document->getNode());
+            return ( NULL != node ) ? document->getDocument()->getString(node) : GString();
+        }
+        GPrimitive value = resolve(root);
+        return ( value != NULL ) ? value->getString() : GString();
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: void addSegment(const StringView& token)
+    {
+        Segment segment;
+        segment.name = CoreFactory::internString(token.data(), token.length());
+        segment.key.chars = segment.name->getBytes();
+        segment.key.length = segment.name->length();
+        segment.key.hash = JsonParser::hashKey(segment.key.chars, segment.key.length);
+        segment.key.cached = 0;
+        segment.index = parseIndex(token);
+        segment.hint = 0;
+        _segments.push_back(segment);
+    }
+
+    /**
+     * Parses array index without sign and leading zeros. Returns -1 if token is not such a number.
+     */
+    private: static int32 parseIndex(const StringView& token)
+    {
+        int32 length = token.length();
+        if ( ( 0 == length ) || ( length > 9 ) || ( ( '0' == token.charAt(0) ) && ( length > 1 ) ) )
+        {
+            return -1;
+        }
+        int32 index = 0;
+        for ( int32 i = 0 ; i < length ; ++i )
+        {
+            char ch = token.charAt(i);
+            if ( ( ch < '0' ) || ( ch > '9' ) )
+            {
+                return -1;
+            }
+            index = index * 10 + ( ch - '0' );
+        }
+        return index;
+    }
+
+    private: static inline bool isNumber(int32 type)
+    {
+        return ( CC::PRIMITIVE_TYPE_LONG == type ) || ( CC::PRIMITIVE_TYPE_DOUBLE == type );
+    }
+
+    private: static inline DocumentPrimitive* asDocument(const GPrimitive& root)
+    {
+        return dynamic_cast< DocumentPrimitive* >(root.get());
+    }
+
+    /**
+     * Walks document nodes. Returns NULL if the path does not resolve.
+     */
+    private: PrimitiveNode* resolve(PrimitiveNode* node) const
+    {
+        if ( !_valid )
+        {
+            return NULL;
+        }
+        for ( size_t i = 0 ; ( i < _segments.size() ) && ( NULL != node ) ; ++i )
+        {
+            node = step(node, _segments[i]);
+        }
+        return node;
+    }
+
+    /**
+     * Walks primitives of any implementation.
+     */
+    private: GPrimitive resolve(const GPrimitive& root) const
+    {
+        if ( !_valid )
+        {
+            return NULL;
+        }
+        GPrimitive value = root;
+        for ( size_t i = 0 ; ( i < _segments.size() ) && ( value != NULL ) ; ++i )
+        {
+            value = step(value, _segments[i]);
+        }
+        return value;
+    }
+
+    private: static PrimitiveNode* step(PrimitiveNode* node, const Segment& segment)
+    {
+        PrimitiveDocument::expand(node);
+        if ( CC::PRIMITIVE_TYPE_OBJECT == node->type )
+        {
+            int32 hint = Concurrent::load(&segment.hint);
+            if ( ( hint < node->size ) && PrimitiveDocument::isSameKey(node->members[hint].key, &segment.key) )
+            {
+                return node->members[hint].value;
+            }
+            int32 position = PrimitiveDocument::findMember(node, &segment.key);
+            if ( position < 0 )
+            {
+                return NULL;
+            }
+            Concurrent::exchange(&segment.hint, position);
+            return node->members[position].value;
+        }
+        if ( ( CC::PRIMITIVE_TYPE_ARRAY == node->type ) && ( segment.index >= 0 ) && ( segment.index < node->size ) )
+        {
+            return node->elements[segment.index];
+        }
+        return NULL;
+    }
+
+    private: static GPrimitive step(const GPrimitive& value, const Segment& segment)
+    {
+        if ( value->isObject() )
+        {
+            return value->get(segment.name);
+        }
+        if ( value->isArray() && ( segment.index >= 0 ) && ( segment.index < value->size() ) )
+        {
+            return value->get(segment.index);
+        }
+        return NULL;
+    }
+};
+
+/**
+ * Set of paths extracted from a tree together.
+ *
+ * Paths are merged into a trie, so a common prefix is walked once no matter how many paths share it:
+ *
+ *     PrimitivePathSet paths;
+ *     int32 lat = paths.add("/location/lat");
+ *     int32 lng = paths.add("/location/lng");
+ *     std::vector< GPrimitive > values(paths.size());
+ *     paths.extract(agent, &values[0]);
+ *
+ * Like PrimitivePath, a populated set can be shared between threads.
+ */
+class PrimitivePathSet
+{
+    private: struct Entry
+    {
+        PrimitivePath::Segment segment;
+
+        int32 firstChild;
+
+        int32 nextSibling;
+
+        /**
+         * Index of the path ending here or -1.
+         */
+        int32 output;
+    };
+
+    /**
+     * Trie of segments. The first entry is the root and has no segment.
+     */
+    private: std::vector< Entry > _entries;
+
+    private: int32 _count;
+
+    public: PrimitivePathSet()
+        : _count(0)
+    {
+        Entry root;
+        root.firstChild = -1;
+        root.nextSibling = -1;
+        root.output = -1;
+        _entries.push_back(root);
+    }
+
+    /**
+     * Adds path to the set. Returns its index in extract() results, or -1 if the path is invalid.
+     * Adding the same path again returns the index it got the first time.
+     */
+    public: int32 add(const PrimitivePath& path)
+    {
+        if ( !path.isValid() )
+        {
+            return -1;
+        }
+        int32 current = 0;
+        for ( int32 i = 0 ; i < path.length() ; ++i )
+        {
+            const PrimitivePath::Segment& segment = path._segments[i];
+            int32 child = _entries[current].firstChild;
+            while ( ( child >= 0 ) && !isSameSegment(_entries[child].segment, segment) )
+            {
+                child = _entries[child].nextSibling;
+            }
+            if ( child < 0 )
+            {
+                Entry entry;
+                entry.segment = segment;
+                entry.segment.hint = 0;
+                entry.firstChild = -1;
+                entry.nextSibling = _entries[current].firstChild;
+                entry.output = -1;
+                child = (int32)_entries.size();
+                _entries.push_back(entry);
+                _entries[current].firstChild = child;
+            }
+            current = child;
+        }
+        if ( _entries[current].output < 0 )
+        {
+            _entries[current].output = _count++;
+        }
+        return _entries[current].output;
+    }
+
+    /**
+     * Compiles and adds JSON Pointer. See add(const PrimitivePath&).
+     */
+    public: int32 add(const StringView& pointer)
+    {
+        return add(PrimitivePath::compile(pointer));
+    }
+
+    /**
+     * Returns number of distinct paths in the set.
+     */
+    public: int32 size() const
+    {
+        return _count;
+    }
+
+    /**
+     * Resolves all paths in a single traversal. results must have room for size() values. Paths that do
+     * not resolve get NULL.
+     */
+    public: void extract(const GPrimitive& root, GPrimitive* results) const
+    {
+        for ( int32 i = 0 ; i < _count ; ++i )
+        {
+            results[i] = NULL;
+        }
+        if ( root == NULL )
+        {
+            return;
+        }
+        DocumentPrimitive* document = PrimitivePath::asDocument(root);
+        if ( NULL != document )
+        {
+            extract(document->getDocument(), document->getNode(), 0, results);
+        }
+        else
+        {
+            extract(root, 0, results);
+        }
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: static bool isSameSegment(const PrimitivePath::Segment& lhs, const PrimitivePath::Segment& rhs)
+    {
+        return ( lhs.key.length == rhs.key.length ) && ( 0 == memcmp(lhs.key.chars, rhs.key.chars, lhs.key.length) );
+    }
+
+    private: void extract(const O< PrimitiveDocument >& document, PrimitiveNode* node, int32 current,
+        GPrimitive* results) const
+    {
+        const Entry& entry = _entries[current];
+        if ( entry.output >= 0 )
+        {
+            results[entry.output] = DocumentPrimitive::wrap(document, node);
+        }
+        for ( int32 child = entry.firstChild ; child >= 0 ; child = _entries[child].nextSibling )
+        {
+            PrimitiveNode* next = PrimitivePath::step(node, _entries[child].segment);
+            if ( NULL != next )
+            {
+                extract(document, next, child, results);
+            }
+        }
+    }
+
+    private: void extract(const GPrimitive& value, int32 current, GPrimitive* results) const
+    {
+        const Entry& entry = _entries[current];
+        if ( entry.output >= 0 )
+        {
+            results[entry.output] = value;
+        }
+        for ( int32 child = entry.firstChild ; child >= 0 ; child = _entries[child].nextSibling )
+        {
+            GPrimitive next = PrimitivePath::step(value, _entries[child].segment);
+            if ( next != NULL )
+            {
+                extract(next, child, results);
+            }
+        }
+    }
+};
+
+}
+
+#endif // !PRIMITIVEPATH_H__GLYMPSE__
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef REFPOLICY_H__GLYMPSE__
+#define REFPOLICY_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Reference counting policy used by Common<T> by default.
+ *
+ * Counters are updated atomically, so objects can be freely shared between threads.
+ */
+class AtomicRefPolicy
+{
+    protected: inline int32 incrementRef(int32* ptr)
+    {
+        return Concurrent::addRelaxed(ptr, 1);
+    }
+
+    protected: inline int32 decrementRef(int32* ptr)
+    {
+        return Concurrent::addAcqRel(ptr, -1);
+    }
+};
+
+/**
+ * Reference counting policy for objects that never leave the thread they were created on
+ * (normally IHandler main thread). Counters are updated with plain arithmetic.
+ *
+ * Debug builds (NDEBUG is not defined) remember the creating thread and assert
+ * that all reference counting happens on it. Release builds carry no extra state.
+ *
+ * <pre>
+ * class PendingLookup : public Common< ICommon, ThreadConfinedRefPolicy >
+ * </pre>
+ *
+ * @note Only use this policy for objects that are referenced from header code alone.
+ * Anything handed to the prebuilt library (listeners, runnables posted to IHandler, values
+ * stored in SDK collections) may be retained and released from its own threads and
+ * must stay on AtomicRefPolicy.
+ */
+class ThreadConfinedRefPolicy
+{
+#if !defined(NDEBUG)
+    private: const void* _owner;
+
+    protected: ThreadConfinedRefPolicy()
+        : _owner(Concurrent::getThreadToken())
+    {
+    }
+
+    private: inline void checkOwner()
+    {
+        assert(( _owner == Concurrent::getThreadToken() ) && "Thread confined object is accessed from foreign thread");
+    }
+#else
+    private: inline void checkOwner()
+    {
+    }
+#endif
+
+    protected: inline int32 incrementRef(int32* ptr)
+    {
+        checkOwner();
+        return ++(*ptr);
+    }
+
+    protected: inline int32 decrementRef(int32* ptr)
+    {
+        checkOwner();
+        return --(*ptr);
+    }
+};
+
+}
+
+#endif // !REFPOLICY_H__GLYMPSE__
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef STOPWATCH_H__GLYMPSE__
+#define STOPWATCH_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Measures elapsed time using CPU timer (see Concurrent::getTicks()).
+ * Starting and reading the stopwatch costs a single register read, so it is suitable for profiling hot paths.
+ */
+class Stopwatch
+{
+    private: int64 _start;
+
+    public: Stopwatch()
+        : _start(Concurrent::getTicks())
+    {
+    }
+
+    /**
+     * Resets the start point to now.
+     */
+    public: inline void restart()
+    {
+        _start = Concurrent::getTicks();
+    }
+
+    /**
+     * Returns elapsed time in raw timer ticks.
+     */
+    public: inline int64 getElapsedTicks() const
+    {
+        return Concurrent::getTicks() - _start;
+    }
+
+    /**
+     * Returns elapsed time in nanoseconds.
+     */
+    public: inline int64 getElapsedNanos() const
+    {
+        return Concurrent::ticksToNanos(getElapsedTicks());
+    }
+
+    /**
+     * Returns elapsed time in milliseconds.
+     */
+    public: inline int64 getElapsedMillis() const
+    {
+        return getElapsedNanos() / 1000000LL;
+    }
+};
+
+/**
+ * Adds time spent in the enclosing scope (in nanoseconds) to the specified accumulator.
+ * <pre>
+ * int64 dispatchNanos = 0;
+ * ...
+ * {
+ *     ScopedTimer timer(&dispatchNanos);
+ *     source->eventsOccurred(...);
+ * }
+ * </pre>
+ */
+class ScopedTimer
+{
+    private: int64* _accumulator;
+
+    private: Stopwatch _stopwatch;
+
+    public: explicit ScopedTimer(int64* accumulator)
+        : _accumulator(accumulator)
+        , _stopwatch()
+    {
+    }
+
+    public: ~ScopedTimer()
+    {
+        *_accumulator += _stopwatch.getElapsedNanos();
+    }
+
+    private: ScopedTimer(const ScopedTimer&);
+    private: ScopedTimer& operator=(const ScopedTimer&);
+};
+
+}
+
+#endif // !STOPWATCH_H__GLYMPSE__
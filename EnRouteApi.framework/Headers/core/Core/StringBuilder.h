@@ -0,0 +1,767 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef STRINGBUILDER_H__GLYMPSE__
+#define STRINGBUILDER_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Non-virtual string builder meant to be used as a local variable.
+ *
+ * Unlike IStringBuilder (see CoreFactory::createStringBuilder()), StringBuilder is not a reference counted
+ * object. The first INLINE_CAPACITY characters are stored inside the builder itself, so building short strings
+ * (keys, URLs, log lines, numbers) never touches the heap. Longer contents spill over into a heap buffer
+ * that grows geometrically.
+ *
+ * Numbers are formatted without going through printf(): integers use a two-digits-at-a-time table,
+ * doubles are converted with Grisu2, which yields the shortest (in rare cases one digit longer)
+ * representation that parses back to the same value.
+ *
+ * The contents are available without copying through view() and data(). toString() makes the single copy
+ * required to create a string object.
+ */
+class StringBuilder
+{
+    /**
+     * Number of characters stored inline before the builder switches to a heap buffer.
+     */
+    public: static const int32 INLINE_CAPACITY = 128;
+
+    /**
+     * Maximum number of characters produced by formatInt64().
+     */
+    public: static const int32 MAX_INT_LENGTH = 20;
+
+    /**
+     * Maximum number of characters produced by formatDouble().
+     */
+    public: static const int32 MAX_DOUBLE_LENGTH = 32;
+
+    private: char* _data;
+
+    private: int32 _length;
+
+    private: int32 _capacity;
+
+    private: char _inline[INLINE_CAPACITY];
+
+    public: StringBuilder() : _data(_inline), _length(0), _capacity(INLINE_CAPACITY)
+    {
+    }
+
+    /**
+     * Creates the builder with room for at least capacity characters.
+     */
+    public: explicit StringBuilder(int32 capacity) : _data(_inline), _length(0), _capacity(INLINE_CAPACITY)
+    {
+        ensureCapacity(capacity);
+    }
+
+    public: StringBuilder(StringBuilder&& other) : _data(_inline), _length(0), _capacity(INLINE_CAPACITY)
+    {
+        takeFrom(other);
+    }
+
+    public: StringBuilder& operator=(StringBuilder&& other)
+    {
+        if ( this != &other )
+        {
+            freeHeap();
+            _data = _inline;
+            _length = 0;
+            _capacity = INLINE_CAPACITY;
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    public: ~StringBuilder()
+    {
+        freeHeap();
+    }
+
+    private: StringBuilder(const StringBuilder&);
+
+    private: StringBuilder& operator=(const StringBuilder&);
+
+    /**
+     * @name Appending
+     */
+
+    public: StringBuilder& append(const char* str, int32 length)
+    {
+        char* target = grow(length);
+        memcpy(target, str, length);
+        return *this;
+    }
+
+    public: StringBuilder& append(const char* str)
+    {
+        return ( NULL != str ) ? append(str, (int32)strlen(str)) : *this;
+    }
+
+    public: StringBuilder& append(const StringView& str)
+    {
+        return append(str.data(), str.length());
+    }
+
+    public: StringBuilder& append(const GString& str)
+    {
+        return ( str != NULL ) ? append(str->getBytes(), str->length()) : *this;
+    }
+
+    public: StringBuilder& append(const StringBuilder& sb)
+    {
+        return append(sb._data, sb._length);
+    }
+
+    public: StringBuilder& append(char c)
+    {
+        *grow(1) = c;
+        return *this;
+    }
+
+    /**
+     * Appends UTF-8 encoding of c.
+     */
+    public: StringBuilder& append(unichar c)
+    {
+        if ( c < 0x80 )
+        {
+            *grow(1) = (char)c;
+        }
+        else if ( c < 0x800 )
+        {
+            char* target = grow(2);
+            target[0] = (char)( 0xC0 | ( c >> 6 ) );
+            target[1] = (char)( 0x80 | ( c & 0x3F ) );
+        }
+        else
+        {
+            char* target = grow(3);
+            target[0] = (char)( 0xE0 | ( c >> 12 ) );
+            target[1] = (char)( 0x80 | ( ( c >> 6 ) & 0x3F ) );
+            target[2] = (char)( 0x80 | ( c & 0x3F ) );
+        }
+        return *this;
+    }
+
+    public: StringBuilder& append(int32 i)
+    {
+        return append((int64)i);
+    }
+
+    public: StringBuilder& append(int64 ll)
+    {
+        char buffer[MAX_INT_LENGTH];
+        int32 length = formatInt64(ll, buffer);
+        return append(buffer, length);
+    }
+
+    public: StringBuilder& append(double d)
+    {
+        char buffer[MAX_DOUBLE_LENGTH];
+        int32 length = formatDouble(d, buffer);
+        return append(buffer, length);
+    }
+
+    /**
+     * @name Contents
+     */
+
+    public: int32 length() const
+    {
+        return _length;
+    }
+
+    public: int32 capacity() const
+    {
+        return _capacity;
+    }
+
+    public: bool isEmpty() const
+    {
+        return 0 == _length;
+    }
+
+    /**
+     * Returns the characters accumulated so far. The pointer is invalidated by the next modification.
+     * The contents are not zero-terminated; see c_str().
+     */
+    public: const char* data() const
+    {
+        return _data;
+    }
+
+    /**
+     * Returns zero-terminated contents. The pointer is invalidated by the next modification.
+     */
+    public: const char* c_str()
+    {
+        ensureCapacity(_length + 1);
+        _data[_length] = '\0';
+        return _data;
+    }
+
+    /**
+     * Returns the view of the characters accumulated so far. The view is invalidated by the next modification.
+     */
+    public: StringView view() const
+    {
+        return StringView(_data, _length);
+    }
+
+    public: void ensureCapacity(int32 capacity)
+    {
+        if ( capacity > _capacity )
+        {
+            reallocate(capacity);
+        }
+    }
+
+    /**
+     * Truncates the contents to length characters. Growing the contents this way is not supported.
+     */
+    public: void setLength(int32 length)
+    {
+        assert( ( length >= 0 ) && ( length <= _length ) );
+        _length = length;
+    }
+
+    /**
+     * Removes all characters but keeps allocated storage for reuse.
+     */
+    public: void clear()
+    {
+        _length = 0;
+    }
+
+    /**
+     * Creates string object with the accumulated characters.
+     */
+    public: GString toString() const
+    {
+        return CoreFactory::createString(_data, _length);
+    }
+
+    /**
+     * @name Number Formatting
+     */
+
+    /**
+     * Writes decimal representation of value into buffer (at least MAX_INT_LENGTH characters long).
+     * The result is not zero-terminated.
+     *
+     * @return Number of characters written.
+     */
+    public: static int32 formatInt64(int64 value, char* buffer)
+    {
+        // Digits are produced from the end of a scratch buffer, two at a time.
+        char scratch[MAX_INT_LENGTH];
+        char* end = scratch + MAX_INT_LENGTH;
+        char* position = end;
+        unsigned long long magnitude = ( value < 0 )
+            ? ( 0ULL - (unsigned long long)value ) : (unsigned long long)value;
+        const char* pairs = getDigitPairs();
+        while ( magnitude >= 100 )
+        {
+            unsigned int pair = (unsigned int)( magnitude % 100 ) * 2;
+            magnitude /= 100;
+            position -= 2;
+            position[0] = pairs[pair];
+            position[1] = pairs[pair + 1];
+        }
+        if ( magnitude >= 10 )
+        {
+            unsigned int pair = (unsigned int)magnitude * 2;
+            position -= 2;
+            position[0] = pairs[pair];
+            position[1] = pairs[pair + 1];
+        }
+        else
+        {
+            *--position = (char)( '0' + magnitude );
+        }
+        if ( value < 0 )
+        {
+            *--position = '-';
+        }
+        int32 length = (int32)( end - position );
+        memcpy(buffer, position, length);
+        return length;
+    }
+
+    /**
+     * Writes the shortest decimal representation of value that parses back to the same double into buffer
+     * (at least MAX_DOUBLE_LENGTH characters long); see Double Formatting for the rare exceptions.
+     * Integral values are written without fraction ("12"), others use "%.17g"-style notation with '.'
+     * as the decimal separator regardless of the current locale.
+     * Non-finite values are written as "NaN", "Infinity" and "-Infinity". The result is not zero-terminated.
+     *
+     * @return Number of characters written.
+     */
+    public: static int32 formatDouble(double value, char* buffer)
+    {
+        if ( value != value )
+        {
+            memcpy(buffer, "NaN", 3);
+            return 3;
+        }
+        if ( value > 1.7976931348623157e308 )
+        {
+            memcpy(buffer, "Infinity", 8);
+            return 8;
+        }
+        if ( value < -1.7976931348623157e308 )
+        {
+            memcpy(buffer, "-Infinity", 9);
+            return 9;
+        }
+
+        // Integral values in the exactly representable range take the integer path.
+        if ( ( value > -9007199254740992.0 ) && ( value < 9007199254740992.0 ) && ( value == (double)(int64)value ) )
+        {
+            if ( ( 0 == (int64)value ) && ( 1.0 / value < 0 ) )
+            {
+                memcpy(buffer, "-0", 2);
+                return 2;
+            }
+            return formatInt64((int64)value, buffer);
+        }
+
+        int32 sign = 0;
+        if ( value < 0 )
+        {
+            buffer[sign++] = '-';
+            value = -value;
+        }
+
+        // value == 0.digits * 10^point
+        char digits[17];
+        int32 count;
+        int32 exponent;
+        shortestDigits(value, digits, count, exponent);
+        int32 point = count + exponent;
+
+        // Same choice between fixed and scientific notation as "%.17g".
+        char* target = buffer + sign;
+        if ( ( point < -3 ) || ( point > 17 ) )
+        {
+            *target++ = digits[0];
+            if ( count > 1 )
+            {
+                *target++ = '.';
+                memcpy(target, digits + 1, count - 1);
+                target += count - 1;
+            }
+            int32 scientific = point - 1;
+            *target++ = 'e';
+            *target++ = ( scientific < 0 ) ? '-' : '+';
+            if ( scientific < 0 )
+            {
+                scientific = -scientific;
+            }
+            if ( scientific >= 100 )
+            {
+                *target++ = (char)( '0' + scientific / 100 );
+                scientific %= 100;
+            }
+            *target++ = (char)( '0' + scientific / 10 );
+            *target++ = (char)( '0' + scientific % 10 );
+        }
+        else if ( point <= 0 )
+        {
+            *target++ = '0';
+            *target++ = '.';
+            memset(target, '0', -point);
+            target += -point;
+            memcpy(target, digits, count);
+            target += count;
+        }
+        else if ( point >= count )
+        {
+            memcpy(target, digits, count);
+            target += count;
+            memset(target, '0', point - count);
+            target += point - count;
+        }
+        else
+        {
+            memcpy(target, digits, point);
+            target += point;
+            *target++ = '.';
+            memcpy(target, digits + point, count - point);
+            target += count - point;
+        }
+        return (int32)( target - buffer );
+    }
+
+    /**
+     * @name Double Formatting
+     *
+     * Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers",
+     * PLDI 2010). Digits are generated with 64-bit integer arithmetic from the boundaries of the rounding
+     * interval of the value, each narrowed by one unit of the approximation error, so the result always
+     * parses back to the same double. It is the shortest such representation for all but a small fraction
+     * of inputs, which get a digit more than necessary.
+     */
+
+    /**
+     * Floating point number f * 2^e with a full 64-bit significand.
+     */
+    private: struct DiyFp
+    {
+        unsigned long long f;
+        int32 e;
+    };
+
+    /**
+     * Normalized 64-bit approximation of 10^k.
+     */
+    private: struct CachedPower
+    {
+        unsigned long long f;
+        int32 e;
+        int32 k;
+    };
+
+    /**
+     * Writes the digits of positive finite value into digits (at least 17 characters long),
+     * so that value == digits * 10^exponent.
+     */
+    private: static void shortestDigits(double value, char* digits, int32& count, int32& exponent)
+    {
+        DiyFp w;
+        DiyFp lower;
+        DiyFp upper;
+        computeBoundaries(value, w, lower, upper);
+
+        // Scaling by the cached power brings the binary exponent into [-60, -32], so the integral part
+        // of the upper boundary fits 32 bits and the digits can be produced with plain integer division.
+        const CachedPower& cached = cachedPower(upper.e);
+        DiyFp power = { cached.f, cached.e };
+        w = multiply(w, power);
+        lower = multiply(lower, power);
+        upper = multiply(upper, power);
+
+        // Each product is off by at most one unit; staying that far inside the interval keeps the
+        // generated digits within the exact one.
+        lower.f += 1;
+        upper.f -= 1;
+        exponent = -cached.k;
+        generateDigits(lower, w, upper, digits, count, exponent);
+    }
+
+    /**
+     * Splits value into its normalized significand and the boundaries halfway to its neighbours,
+     * all sharing the same exponent.
+     */
+    private: static void computeBoundaries(double value, DiyFp& w, DiyFp& lower, DiyFp& upper)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        unsigned long long fraction = bits & 0x000FFFFFFFFFFFFFULL;
+        int32 biased = (int32)( bits >> 52 );
+
+        DiyFp v;
+        if ( 0 == biased )
+        {
+            v.f = fraction;
+            v.e = 1 - 1075;
+        }
+        else
+        {
+            v.f = fraction | 0x0010000000000000ULL;
+            v.e = biased - 1075;
+        }
+
+        // The gap to the previous double is half as wide at powers of two (except for the smallest normal).
+        DiyFp high = { 2 * v.f + 1, v.e - 1 };
+        DiyFp low = { 2 * v.f - 1, v.e - 1 };
+        if ( ( 0 == fraction ) && ( biased > 1 ) )
+        {
+            low.f = 4 * v.f - 1;
+            low.e = v.e - 2;
+        }
+
+        upper = normalize(high);
+        lower.f = low.f << ( low.e - upper.e );
+        lower.e = upper.e;
+        w = normalize(v);
+    }
+
+    private: static DiyFp normalize(DiyFp x)
+    {
+        while ( 0 == ( x.f >> 63 ) )
+        {
+            x.f <<= 1;
+            --x.e;
+        }
+        return x;
+    }
+
+    /**
+     * Returns upper 64 bits of the 128-bit product, rounded.
+     */
+    private: static DiyFp multiply(const DiyFp& x, const DiyFp& y)
+    {
+        unsigned long long a = x.f >> 32;
+        unsigned long long b = x.f & 0xFFFFFFFFULL;
+        unsigned long long c = y.f >> 32;
+        unsigned long long d = y.f & 0xFFFFFFFFULL;
+        unsigned long long ac = a * c;
+        unsigned long long bc = b * c;
+        unsigned long long ad = a * d;
+        unsigned long long bd = b * d;
+        unsigned long long middle = ( bd >> 32 ) + ( ad & 0xFFFFFFFFULL ) + ( bc & 0xFFFFFFFFULL ) + ( 1ULL << 31 );
+        DiyFp result = { ac + ( ad >> 32 ) + ( bc >> 32 ) + ( middle >> 32 ), x.e + y.e + 64 };
+        return result;
+    }
+
+    /**
+     * Returns the cached power of ten that brings binary exponent e into [-60, -32].
+     */
+    private: static const CachedPower& cachedPower(int32 e)
+    {
+        // 10^k for k = -300, -292, ..., 324.
+        static const CachedPower powers[] =
+        {
+            { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+            { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+            { 0xBE5691EF416BD60CULL, -1007, -284 },
+            { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+            { 0xD3515C2831559A83ULL,  -954, -268 },
+            { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+            { 0xEA9C227723EE8BCBULL,  -901, -252 },
+            { 0xAECC49914078536DULL,  -874, -244 },
+            { 0x823C12795DB6CE57ULL,  -847, -236 },
+            { 0xC21094364DFB5637ULL,  -821, -228 },
+            { 0x9096EA6F3848984FULL,  -794, -220 },
+            { 0xD77485CB25823AC7ULL,  -768, -212 },
+            { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+            { 0xEF340A98172AACE5ULL,  -715, -196 },
+            { 0xB23867FB2A35B28EULL,  -688, -188 },
+            { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+            { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+            { 0x936B9FCEBB25C996ULL,  -608, -164 },
+            { 0xDBAC6C247D62A584ULL,  -582, -156 },
+            { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+            { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+            { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+            { 0x87625F056C7C4A8BULL,  -475, -124 },
+            { 0xC9BCFF6034C13053ULL,  -449, -116 },
+            { 0x964E858C91BA2655ULL,  -422, -108 },
+            { 0xDFF9772470297EBDULL,  -396, -100 },
+            { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+            { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+            { 0xB94470938FA89BCFULL,  -316,  -76 },
+            { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+            { 0xCDB02555653131B6ULL,  -263,  -60 },
+            { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+            { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+            { 0xAA242499697392D3ULL,  -183,  -36 },
+            { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+            { 0xBCE5086492111AEBULL,  -130,  -20 },
+            { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+            { 0xD1B71758E219652CULL,   -77,   -4 },
+            { 0x9C40000000000000ULL,   -50,    4 },
+            { 0xE8D4A51000000000ULL,   -24,   12 },
+            { 0xAD78EBC5AC620000ULL,     3,   20 },
+            { 0x813F3978F8940984ULL,    30,   28 },
+            { 0xC097CE7BC90715B3ULL,    56,   36 },
+            { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+            { 0xD5D238A4ABE98068ULL,   109,   52 },
+            { 0x9F4F2726179A2245ULL,   136,   60 },
+            { 0xED63A231D4C4FB27ULL,   162,   68 },
+            { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+            { 0x83C7088E1AAB65DBULL,   216,   84 },
+            { 0xC45D1DF942711D9AULL,   242,   92 },
+            { 0x924D692CA61BE758ULL,   269,  100 },
+            { 0xDA01EE641A708DEAULL,   295,  108 },
+            { 0xA26DA3999AEF774AULL,   322,  116 },
+            { 0xF209787BB47D6B85ULL,   348,  124 },
+            { 0xB454E4A179DD1877ULL,   375,  132 },
+            { 0x865B86925B9BC5C2ULL,   402,  140 },
+            { 0xC83553C5C8965D3DULL,   428,  148 },
+            { 0x952AB45CFA97A0B3ULL,   455,  156 },
+            { 0xDE469FBD99A05FE3ULL,   481,  164 },
+            { 0xA59BC234DB398C25ULL,   508,  172 },
+            { 0xF6C69A72A3989F5CULL,   534,  180 },
+            { 0xB7DCBF5354E9BECEULL,   561,  188 },
+            { 0x88FCF317F22241E2ULL,   588,  196 },
+            { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+            { 0x98165AF37B2153DFULL,   641,  212 },
+            { 0xE2A0B5DC971F303AULL,   667,  220 },
+            { 0xA8D9D1535CE3B396ULL,   694,  228 },
+            { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+            { 0xBB764C4CA7A44410ULL,   747,  244 },
+            { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+            { 0xD01FEF10A657842CULL,   800,  260 },
+            { 0x9B10A4E5E9913129ULL,   827,  268 },
+            { 0xE7109BFBA19C0C9DULL,   853,  276 },
+            { 0xAC2820D9623BF429ULL,   880,  284 },
+            { 0x80444B5E7AA7CF85ULL,   907,  292 },
+            { 0xBF21E44003ACDD2DULL,   933,  300 },
+            { 0x8E679C2F5E44FF8FULL,   960,  308 },
+            { 0xD433179D9C8CB841ULL,   986,  316 },
+            { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+        };
+
+        // k = ceil((-61 - e) * log10(2)), then the first cached power at or above it.
+        int32 f = -61 - e;
+        int32 k = ( f * 78913 ) / ( 1 << 18 ) + ( ( f > 0 ) ? 1 : 0 );
+        return powers[( 300 + k + 7 ) / 8];
+    }
+
+    /**
+     * Produces digits of upper until the remainder falls within [lower, upper], then nudges the last
+     * digit towards w.
+     */
+    private: static void generateDigits(const DiyFp& lower, const DiyFp& w, const DiyFp& upper,
+        char* digits, int32& count, int32& exponent)
+    {
+        unsigned long long delta = upper.f - lower.f;
+        unsigned long long distance = upper.f - w.f;
+        int32 shift = -upper.e;
+        unsigned long long one = 1ULL << shift;
+        unsigned int integral = (unsigned int)( upper.f >> shift );
+        unsigned long long fractional = upper.f & ( one - 1 );
+
+        unsigned int power = 1;
+        int32 remaining = 1;
+        while ( ( remaining < 10 ) && ( integral / 10 >= power ) )
+        {
+            power *= 10;
+            ++remaining;
+        }
+
+        count = 0;
+        while ( remaining > 0 )
+        {
+            digits[count++] = (char)( '0' + integral / power );
+            integral %= power;
+            --remaining;
+            unsigned long long rest = ( (unsigned long long)integral << shift ) + fractional;
+            if ( rest <= delta )
+            {
+                exponent += remaining;
+                roundDigits(digits, count, distance, delta, rest, (unsigned long long)power << shift);
+                return;
+            }
+            power /= 10;
+        }
+
+        for ( ;; )
+        {
+            fractional *= 10;
+            delta *= 10;
+            distance *= 10;
+            digits[count++] = (char)( '0' + ( fractional >> shift ) );
+            fractional &= one - 1;
+            --exponent;
+            if ( fractional <= delta )
+            {
+                break;
+            }
+        }
+        roundDigits(digits, count, distance, delta, fractional, one);
+    }
+
+    private: static void roundDigits(char* digits, int32 count, unsigned long long distance,
+        unsigned long long delta, unsigned long long rest, unsigned long long unit)
+    {
+        while ( ( rest < distance ) && ( delta - rest >= unit )
+            && ( ( rest + unit < distance ) || ( distance - rest > rest + unit - distance ) ) )
+        {
+            --digits[count - 1];
+            rest += unit;
+        }
+    }
+
+    /**
+     * @name Internals
+     */
+
+    /**
+     * Reserves count more characters at the end and returns pointer to them.
+     */
+    private: char* grow(int32 count)
+    {
+        int32 length = _length + count;
+        if ( length > _capacity )
+        {
+            reallocate(length);
+        }
+        char* target = _data + _length;
+        _length = length;
+        return target;
+    }
+
+    private: void reallocate(int32 capacity)
+    {
+        int32 newCapacity = _capacity * 2;
+        if ( newCapacity < capacity )
+        {
+            newCapacity = capacity;
+        }
+        char* data = new char[newCapacity];
+        memcpy(data, _data, _length);
+        freeHeap();
+        _data = data;
+        _capacity = newCapacity;
+    }
+
+    private: void freeHeap()
+    {
+        if ( _data != _inline )
+        {
+            delete [] _data;
+        }
+    }
+
+    /**
+     * Steals the heap buffer of other or copies its inline contents. Leaves other empty.
+     */
+    private: void takeFrom(StringBuilder& other)
+    {
+        if ( other._data != other._inline )
+        {
+            _data = other._data;
+            _capacity = other._capacity;
+            _length = other._length;
+        }
+        else
+        {
+            // Inline contents never exceed INLINE_CAPACITY; the bound only spells that out for the compiler.
+            _length = ( other._length < INLINE_CAPACITY ) ? other._length : INLINE_CAPACITY;
+            memcpy(_inline, other._inline, _length);
+        }
+        other._data = other._inline;
+        other._capacity = INLINE_CAPACITY;
+        other._length = 0;
+    }
+
+    private: static const char* getDigitPairs()
+    {
+        return
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+    }
+};
+
+}
+
+#endif // !STRINGBUILDER_H__GLYMPSE__
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef STRINGPOOL_H__GLYMPSE__
+#define STRINGPOOL_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Global table of interned (unique per content) immortal strings. Backs CoreFactory::internString().
+ *
+ * The table has fixed capacity and is lock-free: lookups never block, concurrent insertions of
+ * the same string resolve to a single instance. Entries are never removed, so the table should only
+ * be used for constants (keys, property names, enum values), not for user data.
+ */
+class StringPool
+{
+    private: StringPool();
+
+    /**
+     * Maximum number of strings the pool can hold. Once it is full, intern() falls back to
+     * CoreFactory::createString().
+     */
+    public: static const int32 CAPACITY = 4096;
+
+    private: static const int32 TABLE_SIZE = 2 * CAPACITY;
+
+    private: struct Entry
+    {
+        unsigned int hash;
+        int32 length;
+        const char* bytes;
+        GString value;
+    };
+
+    /**
+     * Returns interned string with the specified contents.
+     */
+    public: static GString intern(const char* value, int32 length)
+    {
+        unsigned int hash = hashBytes(value, length);
+        Entry** table = getTable();
+        int32 mask = TABLE_SIZE - 1;
+        for ( int32 index = (int32)( hash & mask ), probe = 0 ; probe < TABLE_SIZE ; index = ( index + 1 ) & mask, ++probe )
+        {
+            Entry* entry = Concurrent::load(table + index);
+            if ( NULL == entry )
+            {
+                if ( !claim() )
+                {
+                    break;
+                }
+                entry = new Entry();
+                entry->hash = hash;
+                entry->length = length;
+                entry->value = CoreFactory::createString(value, length);
+                entry->bytes = entry->value->getBytes();
+                if ( Concurrent::compareAndSwap(table + index, (Entry*)NULL, entry) )
+                {
+                    return entry->value;
+                }
+
+                // Another thread took the slot first. Check whether it interned the same string.
+                delete entry;
+                Concurrent::addRelaxed(getCount(), -1);
+                entry = Concurrent::load(table + index);
+            }
+            if ( ( entry->hash == hash ) && ( entry->length == length ) &&
+                ( 0 == memcmp(entry->bytes, value, length) ) )
+            {
+                return entry->value;
+            }
+        }
+        return CoreFactory::createString(value, length);
+    }
+
+    /**
+     * Returns number of strings currently interned.
+     */
+    public: static int32 size()
+    {
+        return Concurrent::load(getCount());
+    }
+
+    /**
+     * FNV-1a hash of length bytes at value. Shared by all header-side string tables
+     * (see also JsonParser::hashKey()).
+     */
+    public: static inline unsigned int hashBytes(const char* value, int32 length)
+    {
+        unsigned int hash = 2166136261u;
+        for ( int32 i = 0 ; i < length ; ++i )
+        {
+            hash ^= (unsigned char)value[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * @name Internals
+     */
+
+    /**
+     * Entries are never freed, so interned strings stay valid even during static destruction.
+     */
+    private: static inline Entry** getTable()
+    {
+        static Entry* table[TABLE_SIZE];
+        return table;
+    }
+
+    private: static inline int32* getCount()
+    {
+        static int32 count;
+        return &count;
+    }
+
+    /**
+     * Reserves room for one more entry. Returns false once the pool is full.
+     * The counter never goes past CAPACITY, no matter how many times this is called.
+     */
+    private: static bool claim()
+    {
+        int32* count = getCount();
+        for ( int32 claimed = Concurrent::load(count) ; claimed < CAPACITY ; claimed = Concurrent::load(count) )
+        {
+            if ( Concurrent::compareAndSwap(count, claimed, claimed + 1) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+inline GString CoreFactory::internString(const char* value)
+{
+    return StringPool::intern(value, (int32)strlen(value));
+}
+
+inline GString CoreFactory::internString(const char* value, int32 length)
+{
+    return StringPool::intern(value, length);
+}
+
+}
+
+#endif // !STRINGPOOL_H__GLYMPSE__
@@ -0,0 +1,502 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef STRINGVIEW_H__GLYMPSE__
+#define STRINGVIEW_H__GLYMPSE__
+
+namespace Glympse
+{
+
+class StringSplitter;
+
+/**
+ * Non-owning reference to a sequence of UTF-8 code units (pointer plus length).
+ *
+ * StringView is a plain value type: copying it is free and none of its operations allocate,
+ * except toString() and intern(). Substrings, trimming and splitting produce views into the same
+ * characters. The view does not keep its characters alive, so it must not outlive the string
+ * it was obtained from (see IString::view()).
+ *
+ * The view is not guaranteed to be zero-terminated.
+ */
+class StringView
+{
+    /**
+     * Returned by search methods when nothing is found.
+     */
+    public: static const int32 NPOS = -1;
+
+    private: const char* _data;
+
+    private: int32 _length;
+
+    /**
+     * Constructs an empty view.
+     */
+    public: StringView() : _data(""), _length(0)
+    {
+    }
+
+    /**
+     * Constructs a view over zero-terminated string. NULL is treated as an empty string.
+     */
+    public: StringView(const char* value)
+        : _data( ( NULL != value ) ? value : "" ), _length( ( NULL != value ) ? (int32)strlen(value) : 0 )
+    {
+    }
+
+    /**
+     * Constructs a view over the first length characters of value.
+     */
+    public: StringView(const char* value, int32 length) : _data(value), _length(length)
+    {
+    }
+
+    /**
+     * Constructs a view over the characters of str. NULL is treated as an empty string.
+     * The caller is responsible for keeping str alive while the view is in use.
+     */
+    public: explicit StringView(const GString& str)
+        : _data( ( str != NULL ) ? str->getBytes() : "" ), _length( ( str != NULL ) ? str->length() : 0 )
+    {
+    }
+
+    /**
+     * @name Accessors
+     */
+
+    public: const char* data() const
+    {
+        return _data;
+    }
+
+    public: int32 length() const
+    {
+        return _length;
+    }
+
+    public: bool isEmpty() const
+    {
+        return 0 == _length;
+    }
+
+    public: char charAt(int32 index) const
+    {
+        assert( ( index >= 0 ) && ( index < _length ) );
+        return _data[index];
+    }
+
+    public: char operator[](int32 index) const
+    {
+        return charAt(index);
+    }
+
+    public: const char* begin() const
+    {
+        return _data;
+    }
+
+    public: const char* end() const
+    {
+        return _data + _length;
+    }
+
+    /**
+     * @name Substrings
+     */
+
+    /**
+     * Returns the view starting at start and extending to the end of this view.
+     */
+    public: StringView substring(int32 start) const
+    {
+        return substring(start, _length);
+    }
+
+    /**
+     * Returns the view of characters in [start, end). Both bounds are clamped to this view.
+     */
+    public: StringView substring(int32 start, int32 end) const
+    {
+        end = ( end < _length ) ? end : _length;
+        start = ( start < 0 ) ? 0 : ( ( start < end ) ? start : end );
+        return StringView(_data + start, end - start);
+    }
+
+    /**
+     * Returns the view with characters <= \\u0020 removed from both ends (same rule as IString::trim()).
+     */
+    public: StringView trim() const
+    {
+        return trimStart().trimEnd();
+    }
+
+    public: StringView trimStart() const
+    {
+        int32 start = 0;
+        while ( ( start < _length ) && ( (unsigned char)_data[start] <= ' ' ) )
+        {
+            ++start;
+        }
+        return StringView(_data + start, _length - start);
+    }
+
+    public: StringView trimEnd() const
+    {
+        int32 end = _length;
+        while ( ( end > 0 ) && ( (unsigned char)_data[end - 1] <= ' ' ) )
+        {
+            --end;
+        }
+        return StringView(_data, end);
+    }
+
+    /**
+     * @name Searching
+     */
+
+    /**
+     * Returns the index of the first occurrence of ch at or after start, or NPOS.
+     */
+    public: int32 indexOf(char ch, int32 start = 0) const
+    {
+        if ( ( start < 0 ) || ( start >= _length ) )
+        {
+            return NPOS;
+        }
+        const char* found = (const char*)memchr(_data + start, ch, _length - start);
+        return ( NULL != found ) ? (int32)( found - _data ) : NPOS;
+    }
+
+    /**
+     * Returns the index of the first occurrence of str at or after start, or NPOS.
+     */
+    public: int32 indexOf(const StringView& str, int32 start = 0) const
+    {
+        if ( start < 0 )
+        {
+            start = 0;
+        }
+        if ( str._length <= 1 )
+        {
+            return ( 0 == str._length )
+                ? ( ( start <= _length ) ? start : NPOS )
+                : indexOf(str._data[0], start);
+        }
+        int32 last = _length - str._length;
+        while ( start <= last )
+        {
+            // Jump to the next candidate by the first character, then verify the rest.
+            const char* found = (const char*)memchr(_data + start, str._data[0], last - start + 1);
+            if ( NULL == found )
+            {
+                break;
+            }
+            if ( 0 == memcmp(found + 1, str._data + 1, str._length - 1) )
+            {
+                return (int32)( found - _data );
+            }
+            start = (int32)( found - _data ) + 1;
+        }
+        return NPOS;
+    }
+
+    /**
+     * Returns the index of the last occurrence of ch, or NPOS.
+     */
+    public: int32 lastIndexOf(char ch) const
+    {
+        for ( int32 i = _length - 1 ; i >= 0 ; --i )
+        {
+            if ( ch == _data[i] )
+            {
+                return i;
+            }
+        }
+        return NPOS;
+    }
+
+    public: bool contains(char ch) const
+    {
+        return NPOS != indexOf(ch);
+    }
+
+    public: bool contains(const StringView& str) const
+    {
+        return NPOS != indexOf(str);
+    }
+
+    public: bool startsWith(const StringView& prefix) const
+    {
+        return ( prefix._length <= _length ) && ( 0 == memcmp(_data, prefix._data, prefix._length) );
+    }
+
+    public: bool endsWith(const StringView& suffix) const
+    {
+        return ( suffix._length <= _length ) &&
+            ( 0 == memcmp(_data + _length - suffix._length, suffix._data, suffix._length) );
+    }
+
+    /**
+     * Returns a splitter enumerating the parts of this view separated by separator.
+     * See StringSplitter for details.
+     */
+    public: inline StringSplitter split(char separator) const;
+
+    /**
+     * Returns a splitter enumerating the parts of this view separated by separator.
+     */
+    public: inline StringSplitter split(const StringView& separator) const;
+
+    /**
+     * @name Comparison
+     */
+
+    public: bool equals(const StringView& str) const
+    {
+        return ( _length == str._length ) &&
+            ( ( _data == str._data ) || ( 0 == memcmp(_data, str._data, _length) ) );
+    }
+
+    /**
+     * Compares ignoring case of ASCII letters. Other characters (including multi-byte UTF-8 sequences)
+     * must match exactly.
+     */
+    public: bool equalsIgnoreCase(const StringView& str) const
+    {
+        return ( _length == str._length ) && ( 0 == compareToIgnoreCase(str) );
+    }
+
+    /**
+     * Lexicographical comparison of UTF-8 code units. Returns 0 if the views are equal,
+     * a negative integer if this view is before str, or a positive integer if it is after str.
+     */
+    public: int32 compareTo(const StringView& str) const
+    {
+        int32 common = ( _length < str._length ) ? _length : str._length;
+        int result = memcmp(_data, str._data, common);
+        return ( 0 != result ) ? result : ( _length - str._length );
+    }
+
+    /**
+     * Same as compareTo() but ignores case of ASCII letters.
+     */
+    public: int32 compareToIgnoreCase(const StringView& str) const
+    {
+        int32 common = ( _length < str._length ) ? _length : str._length;
+        for ( int32 i = 0 ; i < common ; ++i )
+        {
+            int32 result = (int32)toLower(_data[i]) - (int32)toLower(str._data[i]);
+            if ( 0 != result )
+            {
+                return result;
+            }
+        }
+        return _length - str._length;
+    }
+
+    public: bool operator==(const StringView& str) const
+    {
+        return equals(str);
+    }
+
+    public: bool operator!=(const StringView& str) const
+    {
+        return !equals(str);
+    }
+
+    /**
+     * @name Conversion
+     */
+
+    /**
+     * Copies the characters of this view into a new string object.
+     */
+    public: GString toString() const
+    {
+        return CoreFactory::createString(_data, _length);
+    }
+
+    /**
+     * Returns interned string with the contents of this view (see CoreFactory::internString()).
+     */
+    public: GString intern() const
+    {
+        return CoreFactory::internString(_data, _length);
+    }
+
+    private: static inline unsigned char toLower(char ch)
+    {
+        unsigned char value = (unsigned char)ch;
+        return ( ( value >= 'A' ) && ( value <= 'Z' ) ) ? (unsigned char)( value + ( 'a' - 'A' ) ) : value;
+    }
+};
+
+/**
+ * Enumerates parts of a StringView separated by a character or a string without allocating.
+ *
+ * Semantics match a plain split: n separators always yield n + 1 parts, including empty ones
+ * (e.g. "a,,b" yields "a", "", "b"). An empty separator yields the whole source as a single part.
+ *
+ * Parts can be pulled one by one:
+ *
+ *     StringView part;
+ *     while ( splitter.next(part) ) { ... }
+ *
+ * or enumerated with range-based for loop:
+ *
+ *     for ( StringView part : str->view().split(',') ) { ... }
+ */
+class StringSplitter
+{
+    private: StringView _rest;
+
+    private: StringView _separator;
+
+    private: char _separatorChar;
+
+    private: int32 _separatorLength;
+
+    private: bool _done;
+
+    public: StringSplitter(const StringView& source, char separator)
+        : _rest(source), _separatorChar(separator), _separatorLength(1), _done(false)
+    {
+    }
+
+    public: StringSplitter(const StringView& source, const StringView& separator)
+        : _rest(source), _separator(separator), _separatorChar('\0'), _separatorLength(separator.length()), _done(false)
+    {
+        // Single character separators take the faster memchr() path.
+        if ( 1 == _separatorLength )
+        {
+            _separatorChar = separator.charAt(0);
+        }
+    }
+
+    /**
+     * Retrieves the next part. Returns false when all parts have been enumerated.
+     */
+    public: bool next(StringView& part)
+    {
+        if ( _done )
+        {
+            return false;
+        }
+        int32 index = ( 1 == _separatorLength ) ? _rest.indexOf(_separatorChar)
+            : ( ( _separatorLength > 1 ) ? _rest.indexOf(_separator) : StringView::NPOS );
+        if ( StringView::NPOS == index )
+        {
+            part = _rest;
+            _done = true;
+            return true;
+        }
+        part = _rest.substring(0, index);
+        _rest = _rest.substring(index + _separatorLength);
+        return true;
+    }
+
+    /**
+     * Input iterator over the remaining parts. Iterators own a copy of the splitter state,
+     * so the splitter itself is not advanced.
+     */
+    public: class Iterator;
+
+    public: inline Iterator begin() const;
+
+    public: inline Iterator end() const;
+};
+
+class StringSplitter::Iterator
+{
+    public: typedef std::input_iterator_tag iterator_category;
+    public: typedef StringView value_type;
+    public: typedef std::ptrdiff_t difference_type;
+    public: typedef const StringView* pointer;
+    public: typedef const StringView& reference;
+
+    private: StringSplitter _state;
+
+    private: StringView _part;
+
+    private: bool _end;
+
+    public: Iterator(const StringSplitter& state, bool end) : _state(state), _end(end)
+    {
+        if ( !_end )
+        {
+            _end = !_state.next(_part);
+        }
+    }
+
+    public: const StringView& operator*() const
+    {
+        return _part;
+    }
+
+    public: const StringView* operator->() const
+    {
+        return &_part;
+    }
+
+    public: Iterator& operator++()
+    {
+        _end = !_state.next(_part);
+        return *this;
+    }
+
+    public: bool operator==(const Iterator& other) const
+    {
+        // Iterators are only ever compared against end().
+        return _end == other._end;
+    }
+
+    public: bool operator!=(const Iterator& other) const
+    {
+        return _end != other._end;
+    }
+};
+
+inline StringSplitter::Iterator StringSplitter::begin() const
+{
+    return Iterator(*this, false);
+}
+
+inline StringSplitter::Iterator StringSplitter::end() const
+{
+    return Iterator(*this, true);
+}
+
+inline StringSplitter StringView::split(char separator) const
+{
+    return StringSplitter(*this, separator);
+}
+
+inline StringSplitter StringView::split(const StringView& separator) const
+{
+    return StringSplitter(*this, separator);
+}
+
+/*C*/
+inline StringView IString::view()
+{
+    return StringView(getBytes(), length());
+}
+
+inline StringView IString::view(int32 start, int32 end)
+{
+    return view().substring(start, end);
+}
+
+inline StringView IString::trimmedView()
+{
+    return view().trim();
+}
+/**/
+
+}
+
+#endif // !STRINGVIEW_H__GLYMPSE__
@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+//
+// Copyright (c) 2018 Glympse Inc.  All rights reserved.
+//
+//------------------------------------------------------------------------------
+
+#ifndef WEAKOBJECT_H__GLYMPSE__
+#define WEAKOBJECT_H__GLYMPSE__
+
+namespace Glympse
+{
+
+/**
+ * Weak counterpart of O<T>. Refers to an object without keeping it (or objects it references) alive.
+ *
+ * W<T> is built on top of ICommon::hold() and ICommon::unhold(): the memory of referred object
+ * stays allocated until the last W<T> goes away, but the object itself is disposed as soon as
+ * the last O<T> is released (see Common<T>::dispose()).
+ *
+ * Weak reference is promoted to a strong one with lock():
+ * <pre>
+ * O<Helper> helper = _helper.lock();
+ * if ( NULL != helper )
+ * {
+ *     helper->doSomething();
+ * }
+ * </pre>
+ */
+template< class T > class W
+{
+    /**
+     * A pointer to the object we are referencing.
+     */
+    private: T* _object;
+
+    /**
+     * Storage of the same object holding its reference counters.
+     */
+    private: CommonStorage* _storage;
+
+    template< class U > friend class W;
+
+    /**
+     * @name Constructors
+     */
+
+    public: W()
+        : _object(NULL)
+        , _storage(NULL)
+    {
+    }
+    public: W(const O<T>& rO)
+        : _object(rO.get())
+        , _storage(( NULL != _object ) ? dynamic_cast<CommonStorage*>(_object) : NULL)
+    {
+        holdObject();
+    }
+    public: W(const W<T>& rW)
+        : _object(rW._object)
+        , _storage(rW._storage)
+    {
+        holdObject();
+    }
+    public: W(W<T>&& rW)
+        : _object(rW._object)
+        , _storage(rW._storage)
+    {
+        rW._object = NULL;
+        rW._storage = NULL;
+    }
+
+    /**
+     * @name Assignment Operators
+     */
+
+    public: W<T>& operator=(const O<T>& rO)
+    {
+        W<T> tmp(rO);
+        swap(tmp);
+        return *this;
+    }
+    public: W<T>& operator=(const W<T>& rW)
+    {
+        W<T> tmp(rW);
+        swap(tmp);
+        return *this;
+    }
+    public: W<T>& operator=(W<T>&& rW)
+    {
+        W<T> tmp(static_cast< W<T>&& >(rW));
+        swap(tmp);
+        return *this;
+    }
+
+    public: ~W()
+    {
+        unholdObject();
+    }
+
+    /**
+     * @name Access
+     */
+
+    /**
+     * Returns strong reference to the object or empty pointer, if the object is already gone.
+     */
+    public: inline O<T> lock() const
+    {
+        if ( ( NULL != _storage ) && _storage->tryRetain() )
+        {
+            return O<T>(_object);
+        }
+        return O<T>();
+    }
+
+    /**
+     * Checks whether the object has lost its last strong reference.
+     * The result is only a hint, if the object is shared between threads. Use lock() to access the object.
+     */
+    public: inline bool expired() const
+    {
+        return ( NULL == _storage ) || ( 0 == Concurrent::load(&_storage->_ref) );
+    }
+
+    /**
+     * Drops the weak reference (if any) and leaves this instance empty.
+     */
+    public: inline void reset()
+    {
+        unholdObject();
+    }
+
+    public: inline void swap(W<T>& rW)
+    {
+        T* object = _object;
+        CommonStorage* storage = _storage;
+        _object = rW._object;
+        _storage = rW._storage;
+        rW._object = object;
+        rW._storage = storage;
+    }
+
+    /**
+     * Compares referred object with the one referenced by O<T>. Does not require the object to be alive.
+     */
+    public: template< class T2 > inline bool refersTo(const O<T2>& rO) const
+    {
+        return ( NULL != _object ) && ( _object == ObjectCast<T, T2>::cast(rO.get()) );
+    }
+
+    /**
+     * @name Internals
+     */
+
+    private: inline void holdObject()
+    {
+        if ( _object )
+        {
+            _object->hold();
+        }
+    }
+
+    private: inline void unholdObject()
+    {
+        if ( _object )
+        {
+            _object->unhold();
+            _object = NULL;
+            _storage = NULL;
+        }
+    }
+};
+
+}
+
+#endif // !WEAKOBJECT_H__GLYMPSE__
@@ -48,7 +48,7 @@ template< class T > class Holder
     public: template< class T2 > Holder<T>& operator=(const O<T2>& rO)
     {
         release();
-        _object = dynamic_cast<T*>(rO.operator->());
+        _object = ObjectCast<T, T2>::cast(rO.operator->());
         retain();
         return *this;
     }
@@ -28,7 +28,7 @@ namespace Toolbox
      */
     public: static GString GOGO_PROVIDER_ID()
     {
-        return CoreFactory::createString("gogo");
+        return CoreFactory::internString("gogo");
     }
     
     /**
@@ -47,7 +47,7 @@ namespace Toolbox
      */
     public: static GString MODE_PROPERTY()
     {
-        return CoreFactory::createString("battery_mode");
+        return CoreFactory::internString("battery_mode");
     }
     
     /**
@@ -313,11 +313,11 @@ namespace Toolbox
         GString mode = NULL;
         if ( MODE_REGULAR == _mode )
         {
-            mode = CoreFactory::createString("regular");
+            mode = CoreFactory::internString("regular");
         }
         else if ( MODE_SAVINGS == _mode )
         {
-            mode = CoreFactory::createString("savings");
+            mode = CoreFactory::internString("savings");
         }
         if ( NULL == mode )
         {
@@ -405,13 +405,8 @@ namespace Toolbox
             _mode = MODE_DEFAULT;
             return;
         }
-        GPrimitive app = contents->get(CoreFactory::createString("app"));
-        if ( NULL == app )
-        {
-            _mode = MODE_DEFAULT;
-            return;
-        }
-        int32 mode = (int32)app->getLong(CoreFactory::createString("battery_mode"));
+        static const PrimitivePath MODE_PATH = PrimitivePath::compile("/app/battery_mode");
+        int32 mode = (int32)MODE_PATH.getLong(contents, 0);
         _mode = ( 0 == mode ) ? MODE_DEFAULT : mode;
     }
     
@@ -432,13 +427,13 @@ namespace Toolbox
         }
         
         // Save mode.
-        GPrimitive app = contents->get(CoreFactory::createString("app"));
+        GPrimitive app = contents->get(CoreFactory::internString("app"));
         if ( NULL == app )
         {
             app = CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_OBJECT);
-            contents->put(CoreFactory::createString("app"), app);
+            contents->put(CoreFactory::internString("app"), app);
         }
-        app->put(CoreFactory::createString("battery_mode"), (int64)_mode);
+        app->put(CoreFactory::internString("battery_mode"), (int64)_mode);
         
         // Save config. 
         _config->save();
@@ -172,14 +172,14 @@ namespace Toolbox
         if ( NULL == conversation )
         {
             conversation = CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_OBJECT);
-            conversation->put(CoreFactory::createString("incoming"), CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_ARRAY));
+            conversation->put(CoreFactory::internString("incoming"), CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_ARRAY));
 
             _cache->put(conversationId, conversation);
         }
 
         // Set the outgoing invite code. This will overwrite any outgoing invite code
         // previously set for this conversation.
-        conversation->put(CoreFactory::createString("outgoing"), code);
+        conversation->put(CoreFactory::internString("outgoing"), code);
 
         // Save the cache to persisted storage.
         _storage->save(_cache);
@@ -212,7 +212,7 @@ namespace Toolbox
         if ( NULL == conversation )
         {
             conversation = CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_OBJECT);
-            conversation->put(CoreFactory::createString("incoming"), CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_ARRAY));
+            conversation->put(CoreFactory::internString("incoming"), CoreFactory::createPrimitive(CC::PRIMITIVE_TYPE_ARRAY));
 
             _cache->put(conversationId, conversation);
         }
@@ -220,7 +220,7 @@ namespace Toolbox
         // Add this invite code to the array of incoming invite codes. To protect
         // against the same invite code from being added twice, we first attempt to
         // remove the specified code from the array before adding it back.
-        GPrimitive incoming = conversation->get(CoreFactory::createString("incoming"));
+        GPrimitive incoming = conversation->get(CoreFactory::internString("incoming"));
         remove(incoming, code);
         incoming->put(CoreFactory::createPrimitive(code));
 
@@ -260,7 +260,7 @@ namespace Toolbox
         }
 
         // If the cache contains no outgoing invite code, exit now.
-        GPrimitive outgoing = conversation->get(CoreFactory::createString("outgoing"));
+        GPrimitive outgoing = conversation->get(CoreFactory::internString("outgoing"));
         if ( NULL == outgoing )
         {
             return;
@@ -270,11 +270,11 @@ namespace Toolbox
         // code, remove it.
         if ( outgoing->getString()->equals(code) )
         {
-            conversation->remove(CoreFactory::createString("outgoing"));
+            conversation->remove(CoreFactory::internString("outgoing"));
 
             // Now that we've removed the outgoing invite code, if the size of the incoming
             // invite code array is empty, we can delete the entire entry for this conversation.
-            if ( conversation->get(CoreFactory::createString("incoming"))->size() == 0 )
+            if ( conversation->get(CoreFactory::internString("incoming"))->size() == 0 )
             {
                 _cache->remove(conversationId);
             }
@@ -315,12 +315,12 @@ namespace Toolbox
 
         // NOTE: If the cache contains storage for this conversation, then it
         // is guaranteed to have an array to contain incoming invite codes.
-        GPrimitive incoming = conversation->get(CoreFactory::createString("incoming"));
+        GPrimitive incoming = conversation->get(CoreFactory::internString("incoming"));
         remove(incoming, code);
 
         // If the size of the incoming invite code array is now zero AND there is no
         // outgoing invite code, we can delete the entire entry for this conversation.
-        if (( incoming->size() == 0 ) && ( NULL == conversation->get(CoreFactory::createString("outgoing")) ))
+        if (( incoming->size() == 0 ) && ( NULL == conversation->get(CoreFactory::internString("outgoing")) ))
         {
             _cache->remove(conversationId);
         }
@@ -393,7 +393,7 @@ namespace Toolbox
         }
 
         // If the conversation has no entry for an outgoing ticket, exit now.
-        GPrimitive outgoing = conversation->get(CoreFactory::createString("outgoing"));
+        GPrimitive outgoing = conversation->get(CoreFactory::internString("outgoing"));
         if ( NULL == outgoing )
         {
             return NULL;
@@ -427,7 +427,7 @@ namespace Toolbox
         }
 
         // NOTE: This will never return NULL, but may return an empty GPrimitive array.
-        return conversation->get(CoreFactory::createString("incoming"));
+        return conversation->get(CoreFactory::internString("incoming"));
     }
 
     /**
@@ -64,7 +64,8 @@ namespace Toolbox
         {
             return false;
         }
-        new CurrentLocationHelper(glympse, listener, locationTimeoutMillis);
+        // The helper is kept alive by the platform while it is subscribed on platform events.
+        O<CurrentLocationHelper> helper(new CurrentLocationHelper(glympse, listener, locationTimeoutMillis));
         return true;
     }
 
@@ -84,7 +85,7 @@ namespace Toolbox
 
     private: void setLocationTimeout()
     {
-        _locationTimeout = new LocationTimeout(Object::fromThis(this));
+        _locationTimeout = new LocationTimeout(W<CurrentLocationHelper>(Object::fromThis(this)));
         _glympse->getHandler()->postDelayed(_locationTimeout, _locationTimeoutMillis);
     }
 
@@ -128,6 +129,28 @@ namespace Toolbox
         setLocationTimeout();
     }
 
+    /**
+     * @name Common section
+     */
+
+    /**
+     * Undoes what the constructor started, if the helper is abandoned (e.g. platform drops
+     * its listeners) before the listener got satisfied or gave up. Location updates requested
+     * by the helper are stopped and the listener is told that no location is coming.
+     */
+    protected: virtual void dispose()
+    {
+        cleanupLocationTimeout();
+        if ( NULL != _locationManager )
+        {
+            _locationManager->stopLocation(false);
+            _locationManager = NULL;
+            _listener->locationError();
+        }
+        _listener = NULL;
+        _glympse = NULL;
+    }
+
     /**
      * @name GEventListener section
      */
@@ -161,16 +184,20 @@ namespace Toolbox
 
     private: class LocationTimeout : public Common< IRunnable >
     {
-        private: O<CurrentLocationHelper> _helper;
+        private: W<CurrentLocationHelper> _helper;
 
-        public: LocationTimeout(const O<CurrentLocationHelper>& helper)
+        public: LocationTimeout(const W<CurrentLocationHelper>& helper)
         {
             _helper = helper;
         }
 
         public: /*S*override**/ void run()
         {
-            _helper->timeoutLocation();
+            O<CurrentLocationHelper> helper = _helper.lock();
+            if ( NULL != helper )
+            {
+                helper->timeoutLocation();
+            }
         }
     };
 };
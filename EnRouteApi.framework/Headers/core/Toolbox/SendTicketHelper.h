@@ -32,7 +32,8 @@ namespace Toolbox
     public: static void send(const GGlympse& glympse, const GListener& listener,
         const GTicket& ticket, int64 locationTimeoutMillis)
     {
-        new SendTicketHelper(glympse, listener, ticket, locationTimeoutMillis);
+        // The helper is kept alive by the platform and the ticket while it is subscribed on their events.
+        O<SendTicketHelper> helper(new SendTicketHelper(glympse, listener, ticket, locationTimeoutMillis));
     }
 
     private: SendTicketHelper(const GGlympse& glympse, const GListener& listener,
@@ -47,7 +48,7 @@ namespace Toolbox
         _locationManager = _glympse->getLocationManager();
         _locationManager->startLocation();
 
-        _locationTimeout = new LocationTimeout(Object::fromThis(this));
+        _locationTimeout = new LocationTimeout(W<SendTicketHelper>(Object::fromThis(this)));
         _glympse->getHandler()->postDelayed(_locationTimeout, locationTimeoutMillis);
     }
 
@@ -91,6 +92,37 @@ namespace Toolbox
         _listener->locationFailed();
     }
 
+    /**
+     * @name Common section
+     */
+
+    /**
+     * Undoes what the constructor started, if the helper is abandoned (e.g. platform or ticket
+     * drop their listeners) before the invite got created or failed. Location updates requested
+     * by the helper are stopped and the listener gets the failure callback of the pending stage.
+     */
+    protected: virtual void dispose()
+    {
+        bool waitingForLocation = ( NULL != _locationTimeout );
+        cleanupLocationTimeout();
+        if ( NULL != _locationManager )
+        {
+            _locationManager->stopLocation(false);
+            _locationManager = NULL;
+            if ( waitingForLocation )
+            {
+                _listener->locationFailed();
+            }
+            else
+            {
+                _listener->inviteFailed();
+            }
+        }
+        _ticket = NULL;
+        _listener = NULL;
+        _glympse = NULL;
+    }
+
     /**
      * @name GEventListener section
      */
@@ -145,16 +177,20 @@ namespace Toolbox
 
     private: class LocationTimeout : public Common< IRunnable >
     {
-        private: O<SendTicketHelper> _helper;
+        private: W<SendTicketHelper> _helper;
 
-        public: LocationTimeout(const O<SendTicketHelper>& helper)
+        public: LocationTimeout(const W<SendTicketHelper>& helper)
         {
             _helper = helper;
         }
 
         public: /*S*override**/ void run()
         {
-            _helper->timeoutLocation();
+            O<SendTicketHelper> helper = _helper.lock();
+            if ( NULL != helper )
+            {
+                helper->timeoutLocation();
+            }
         }
     };
 };
@@ -125,39 +125,39 @@ namespace EnRoute
     
     public: static GString PHASE_PROPERTY_KEY()
     {
-        return CoreFactory::createString("phase");
+        return CoreFactory::internString("phase");
     }
     public: static GString PHASE_PROPERTY_UNKNOWN()
     {
-        return CoreFactory::createString("unknown");
+        return CoreFactory::internString("unknown");
     }
     public: static GString PHASE_PROPERTY_PRE()
     {
-        return CoreFactory::createString("pre");
+        return CoreFactory::internString("pre");
     }
     public: static GString PHASE_PROPERTY_ETA()
     {
-        return CoreFactory::createString("eta");
+        return CoreFactory::internString("eta");
     }
     public: static GString PHASE_PROPERTY_LIVE()
     {
-        return CoreFactory::createString("live");
+        return CoreFactory::internString("live");
     }
     public: static GString PHASE_PROPERTY_ARRIVED()
     {
-        return CoreFactory::createString("arrived");
+        return CoreFactory::internString("arrived");
     }
     public: static GString PHASE_PROPERTY_FEEDBACK()
     {
-        return CoreFactory::createString("feedback");
+        return CoreFactory::internString("feedback");
     }
     public: static GString PHASE_PROPERTY_COMPLETED()
     {
-        return CoreFactory::createString("completed");
+        return CoreFactory::internString("completed");
     }
     public: static GString PHASE_PROPERTY_NOT_COMPLETED()
     {
-        return CoreFactory::createString("not_completed");
+        return CoreFactory::internString("not_completed");
     }
     
     /**
@@ -165,17 +165,17 @@ namespace EnRoute
      */
     public: static GString SESSION_CONTROL_MODE_MANUAL()
     {
-        return CoreFactory::createString("manual");
+        return CoreFactory::internString("manual");
     }
     
     public: static GString SESSION_CONTROL_MODE_SHUTTLE_SERVICE()
     {
-        return CoreFactory::createString("sdk_shuttle_service");
+        return CoreFactory::internString("sdk_shuttle_service");
     }
     
     public: static GString SESSION_CONTROL_MODE_FOOD_DELIVERY()
     {
-        return CoreFactory::createString("sdk_food_delivery");
+        return CoreFactory::internString("sdk_food_delivery");
     }
 };
     